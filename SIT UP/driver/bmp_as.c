@@ -68,6 +68,10 @@
 // Valid sleep phase durations are: 1, 2, 4, 6, 10, 25, 50
 #define BMP_AS_SLEEPPHASE   (6u)
 
+// Motion wakeup: low power mode with 50ms sleep phase, slope threshold in 3.91mg steps (2g range)
+#define BMP_AS_MOTION_SLEEP      (0x58)
+#define BMP_AS_MOTION_THRESHOLD  (20u)
+
 // *************************************************************************************************
 // @fn          bmp_as_start
 // @brief       Power-up and initialize acceleration sensor
@@ -152,6 +156,8 @@ void bmp_as_start(void)
 	bmp_as_write_register(BMP_SCR, 0x80);        // acquire unfiltered acceleration data
 #endif
 	// configure sensor interrupt
+	bmp_as_write_register(BMP_ISR1, 0x00);       // disable slope interrupt (motion wakeup)
+	bmp_as_write_register(BMP_IMR1, 0x00);       // unmap slope interrupt
 	bmp_as_write_register(BMP_IMR2, 0x01);       // map new data interrupt to INT1 pin
 	bmp_as_write_register(BMP_ISR2, 0x10);       // enable new data interrupt
 	
@@ -160,6 +166,30 @@ void bmp_as_start(void)
 	AS_INT_IE  |=  AS_INT_PIN;                   // Enable interrupt
 }
 
+// *************************************************************************************************
+// @fn          bmp_as_start_motion
+// @brief       Keep sensor powered, but only wake up on motion. Sensor sleeps 50ms between
+//              samples and raises INT1 on a slope above threshold instead of new data.
+//              bmp_as_start() returns to normal data acquisition.
+// @param       none
+// @return      none
+// *************************************************************************************************
+void bmp_as_start_motion(void)
+{
+	// Exit if sensor is not powered up
+	if ((AS_PWR_OUT & AS_PWR_PIN) != AS_PWR_PIN) return;
+
+	bmp_as_write_register(BMP_ISR2, 0x00);       // disable new data interrupt
+	bmp_as_write_register(BMP_IMR2, 0x00);       // unmap new data interrupt
+	bmp_as_write_register(BMP_SLOPE_DUR, 0x00);  // slope interrupt after 1 sample
+	bmp_as_write_register(BMP_SLOPE_THR, BMP_AS_MOTION_THRESHOLD);
+	bmp_as_write_register(BMP_IMR1, 0x04);       // map slope interrupt to INT1 pin
+	bmp_as_write_register(BMP_ISR1, 0x07);       // enable slope interrupt on X/Y/Z
+	bmp_as_write_register(BMP_PM, BMP_AS_MOTION_SLEEP); // longer sleep phase
+
+	AS_INT_IFG &= ~AS_INT_PIN;                   // Reset flag
+}
+
 // *************************************************************************************************
 // @fn          bmp_as_stop
 // @brief       Power down acceleration sensor
@@ -212,7 +242,9 @@ void bmp_as_get_data(unsigned char * data)
   	// Dummy read LSB from LSB acceleration data to update MSB (BMA250 datasheet 4.4.1)
   	*(data+0) = bmp_as_read_register(BMP_ACC_X_LSB);
 	*(data+1) = bmp_as_read_register(BMP_ACC_Y_LSB);
+	*(data+2) = bmp_as_read_register(BMP_ACC_Z_LSB);
   	// Store X/Y/Z MSB acceleration data in buffer
 	*(data+0) = bmp_as_read_register(BMP_ACC_X_MSB);
 	*(data+1) = bmp_as_read_register(BMP_ACC_Y_MSB);
+	*(data+2) = bmp_as_read_register(BMP_ACC_Z_MSB);
 }
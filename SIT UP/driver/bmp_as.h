@@ -36,6 +36,7 @@
 // *************************************************************************************************
 // Prototypes section
 extern void bmp_as_start(void);
+extern void bmp_as_start_motion(void);
 extern void bmp_as_stop(void);
 extern unsigned char bmp_as_read_register(unsigned char bAddress);
 extern unsigned char bmp_as_write_register(unsigned char bAddress, unsigned char bData);
@@ -51,6 +52,8 @@ extern void bmp_as_get_data(unsigned char * data);
 #define BMP_ACC_X_MSB        (0x03)
 #define BMP_ACC_Y_LSB        (0x04)
 #define BMP_ACC_Y_MSB        (0x05)
+#define BMP_ACC_Z_LSB        (0x06)
+#define BMP_ACC_Z_MSB        (0x07)
 
 #define BMP_GRANGE           (0x0F)	   // g Range
 #define BMP_BWD              (0x10)	   // Bandwidth
@@ -62,5 +65,7 @@ extern void bmp_as_get_data(unsigned char * data);
 #define BMP_IMR1             (0x19)	   // Interrupt mapping register 1
 #define BMP_IMR2             (0x1A)	   // Interrupt mapping register 2
 #define BMP_IMR3             (0x1B)	   // Interrupt mapping register 3
+#define BMP_SLOPE_DUR        (0x27)	   // Slope interrupt duration
+#define BMP_SLOPE_THR        (0x28)	   // Slope interrupt threshold
 
 #endif /*BMP_AS_H_*/
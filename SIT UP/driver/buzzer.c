@@ -49,6 +49,9 @@ void countdown_buzzer(void);
 // Global Variable section
 struct buzzer sBuzzer;
 
+// On/off duty cycle timer
+struct soft_timer sBuzzerTimer;
+
 // *************************************************************************************************
 // @fn          reset_buzzer
 // @brief       Init buzzer variables
@@ -90,12 +93,8 @@ void start_buzzer(unsigned char cycles, unsigned short on_time, unsigned short o
         // Allow buzzer PWM output on P2.7
         P2SEL |= BIT7;
 
-        // Activate Timer0_A3 periodic interrupts
-        fptr_Timer0_A3_function = toggle_buzzer;
-        Timer0_A3_Start(sBuzzer.on_time);
-
-        // Preload timer advance variable
-        sTimer.timer0_A3_ticks = sBuzzer.off_time;
+        // Turn output off after on_time
+        soft_timer_start(&sBuzzerTimer, toggle_buzzer, sBuzzer.on_time, 0);
 
         // Start with buzzer output on
         sBuzzer.state = BUZZER_ON_OUTPUT_ENABLED;
@@ -123,8 +122,8 @@ void toggle_buzzer(void)
         // Update buzzer state
         sBuzzer.state = BUZZER_ON_OUTPUT_DISABLED;
 
-        // Reload Timer0_A4 IRQ to restart output
-        sTimer.timer0_A3_ticks = sBuzzer.on_time;
+        // Restart output after off_time
+        soft_timer_start(&sBuzzerTimer, toggle_buzzer, sBuzzer.off_time, 0);
     }
     else                        // Turn on buzzer
     {
@@ -144,8 +143,8 @@ void toggle_buzzer(void)
             // Update buzzer state
             sBuzzer.state = BUZZER_ON_OUTPUT_ENABLED;
 
-            // Reload Timer0_A4 IRQ to turn off output
-            sTimer.timer0_A3_ticks = sBuzzer.off_time;
+            // Turn off output after on_time
+            soft_timer_start(&sBuzzerTimer, toggle_buzzer, sBuzzer.on_time, 0);
         }
     }
 }
@@ -168,8 +167,8 @@ void stop_buzzer(void)
     // Clear PWM timer interrupt
     TA1CCTL0 &= ~CCIE;
 
-    // Disable periodic start/stop interrupts
-    Timer0_A3_Stop();
+    // Disable start/stop timer
+    soft_timer_stop(&sBuzzerTimer);
 
     // Clear variables
     reset_buzzer();
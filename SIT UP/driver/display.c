@@ -46,23 +46,84 @@
 // *************************************************************************************************
 // Prototypes section
 void write_lcd_mem(unsigned char * lcdmem, unsigned char bits, unsigned char bitmask, unsigned char state);
+void lcd_flush(void);
+void lcd_power_mode(unsigned char mode);
+void lcd_blank(unsigned char blank);
+void lcd_control(unsigned short ctl0, unsigned short vctl);
+void lcd_copy_mem(unsigned char * lcdmem, unsigned char * shadow, unsigned short mask);
+void display_animation(unsigned char animation);
+void display_frame(unsigned char frame);
 void clear_line(unsigned char line);
 void display_symbol(unsigned char symbol, unsigned char mode);
 void display_char(unsigned char segment, unsigned char chr, unsigned char mode);
 void display_chars(unsigned char segments, unsigned char * str, unsigned char mode);
-
-// Table with memory bit assignment for digits "0" to "9" and characters "A" to "Z"
+void int_to_digits(unsigned int n, unsigned char * str, unsigned char digits, unsigned char blanks);
+void display_counter_reset(struct lcd_counter *counter, unsigned char segment, unsigned char digits,
+                           unsigned char blanks);
+void display_counter(struct lcd_counter *counter, unsigned int value);
+
+// Glyphs for characters '-' (0x2D) to 'Z' (0x5A), bits assigned as on Line1
+#define LCD_FONT(GLYPH) \
+    GLYPH(SEG_G)                                            /* "-" */ \
+    GLYPH(0)                                                /* " " */ \
+    GLYPH(0)                                                /* " " */ \
+    GLYPH(SEG_A + SEG_B + SEG_C + SEG_D + SEG_E + SEG_F)    /* "0" */ \
+    GLYPH(SEG_B + SEG_C)                                    /* "1" */ \
+    GLYPH(SEG_A + SEG_B + SEG_D + SEG_E + SEG_G)            /* "2" */ \
+    GLYPH(SEG_A + SEG_B + SEG_C + SEG_D + SEG_G)            /* "3" */ \
+    GLYPH(SEG_B + SEG_C + SEG_F + SEG_G)                    /* "4" */ \
+    GLYPH(SEG_A + SEG_C + SEG_D + SEG_F + SEG_G)            /* "5" */ \
+    GLYPH(SEG_A + SEG_C + SEG_D + SEG_E + SEG_F + SEG_G)    /* "6" */ \
+    GLYPH(SEG_A + SEG_B + SEG_C)                            /* "7" */ \
+    GLYPH(SEG_A + SEG_B + SEG_C + SEG_D + SEG_E + SEG_F + SEG_G) /* "8" */ \
+    GLYPH(SEG_A + SEG_B + SEG_C + SEG_D + SEG_F + SEG_G)    /* "9" */ \
+    GLYPH(0)                                                /* " " */ \
+    GLYPH(0)                                                /* " " */ \
+    GLYPH(0)                                                /* " " */ \
+    GLYPH(0)                                                /* " " */ \
+    GLYPH(0)                                                /* " " */ \
+    GLYPH(SEG_D + SEG_E + SEG_G)                            /* "c" */ \
+    GLYPH(0)                                                /* " " */ \
+    GLYPH(SEG_A + SEG_B + SEG_C + SEG_E + SEG_F + SEG_G)    /* "A" */ \
+    GLYPH(SEG_C + SEG_D + SEG_E + SEG_F + SEG_G)            /* "b" */ \
+    GLYPH(SEG_A + SEG_D + SEG_E + SEG_F)                    /* "C" */ \
+    GLYPH(SEG_B + SEG_C + SEG_D + SEG_E + SEG_G)            /* "d" */ \
+    GLYPH(SEG_A + +SEG_D + SEG_E + SEG_F + SEG_G)           /* "E" */ \
+    GLYPH(SEG_A + SEG_E + SEG_F + SEG_G)                    /* "F" */ \
+    /* SEG_A+      SEG_C+SEG_D+SEG_E+SEG_F+SEG_G,       Displays "G" */ \
+    GLYPH(SEG_A + SEG_B + SEG_C + SEG_D + SEG_F + SEG_G)    /* "g" */ \
+    GLYPH(SEG_B + SEG_C + SEG_E + SEG_F + SEG_G)            /* "H" */ \
+    GLYPH(SEG_E + SEG_F)                                    /* "I" */ \
+    GLYPH(SEG_A + SEG_B + SEG_C + SEG_D)                    /* "J" */ \
+    /* SEG_B+SEG_C+      SEG_E+SEG_F+SEG_G,     Displays "k" */ \
+    GLYPH(SEG_D + SEG_E + SEG_F + SEG_G)                    /* "k" */ \
+    GLYPH(SEG_D + SEG_E + SEG_F)                            /* "L" */ \
+    GLYPH(SEG_A + SEG_B + SEG_C + SEG_E + SEG_F)            /* "M" */ \
+    GLYPH(SEG_C + SEG_E + SEG_G)                            /* "n" */ \
+    GLYPH(SEG_C + SEG_D + SEG_E + SEG_G)                    /* "o" */ \
+    GLYPH(SEG_A + SEG_B + SEG_E + SEG_F + SEG_G)            /* "P" */ \
+    GLYPH(SEG_A + SEG_B + SEG_C + SEG_D + SEG_E + SEG_F)    /* "Q" */ \
+    GLYPH(SEG_E + SEG_G)                                    /* "r" */ \
+    GLYPH(SEG_A + SEG_C + SEG_D + SEG_F + SEG_G)            /* "S" */ \
+    GLYPH(SEG_D + SEG_E + SEG_F + SEG_G)                    /* "t" */ \
+    GLYPH(SEG_C + SEG_D + SEG_E)                            /* "u" */ \
+    GLYPH(SEG_C + SEG_D + SEG_E)                            /* "u" */ \
+    GLYPH(SEG_G)                                            /* "-" */ \
+    GLYPH(SEG_B + SEG_C + +SEG_E + SEG_F + SEG_G)           /* "X" */ \
+    GLYPH(SEG_B + SEG_C + SEG_D + SEG_F + SEG_G)            /* "Y" */ \
+    GLYPH(SEG_A + SEG_B + SEG_D + SEG_E + SEG_G)            /* "Z" */
+
+// Line2 characters are wired with high and low nibble swapped against Line1
+#define LCD_GLYPH_L1(bits)              (bits),
+#define LCD_GLYPH_L2(bits)              ((((bits) << 4) & 0xF0) | (((bits) >> 4) & 0x0F)),
+
+// Font tables with ready to write bits for Line1 and Line2 positions, generated at compile time
 const unsigned char lcd_font[] = {
-    SEG_A + SEG_B + SEG_C + SEG_D + SEG_E + SEG_F,         // Displays "0"
-    SEG_B + SEG_C,                                         // Displays "1"
-    SEG_A + SEG_B + SEG_D + SEG_E + SEG_G,                 // Displays "2"
-    SEG_A + SEG_B + SEG_C + SEG_D + SEG_G,                 // Displays "3"
-    SEG_B + SEG_C + SEG_F + SEG_G,                         // Displays "4"
-    SEG_A + SEG_C + SEG_D + SEG_F + SEG_G,                 // Displays "5"
-    SEG_A + SEG_C + SEG_D + SEG_E + SEG_F + SEG_G,         // Displays "6"
-    SEG_A + SEG_B + SEG_C,                                 // Displays "7"
-    SEG_A + SEG_B + SEG_C + SEG_D + SEG_E + SEG_F + SEG_G, // Displays "8"
-    SEG_A + SEG_B + SEG_C + SEG_D + SEG_F + SEG_G,         // Displays "9"
+    LCD_FONT(LCD_GLYPH_L1)
+};
+
+const unsigned char lcd_font_l2[] = {
+    LCD_FONT(LCD_GLYPH_L2)
 };
 
 // Table with memory address for each display element
@@ -159,27 +220,21 @@ const unsigned char segments_bitmask[] = {
     LCD_SEG_L2_DP_MASK,
 };
 
-// Quick integer to array conversion table for most common integer values
-
-const unsigned char int_to_array_conversion_table[][3] = {
-	"000", "001", "002", "003", "004", "005", "006", "007", "008", "009", "010", "011", "012",
-	"013", "014", "015",
-	"016", "017","018", "019", "020", "021", "022", "023", "024", "025", "026", "027", "028",
-    "029", "030", "031",
-    "032", "033", "034", "035", "036", "037", "038", "039", "040", "041", "042", "043", "044",
-    "045", "046", "047",
-    "048", "049", "050", "051", "052", "053", "054", "055", "056", "057", "058", "059", "060",
-    "061", "062", "063",
-    "064", "065", "066", "067", "068", "069", "070", "071", "072", "073", "074", "075", "076",
-    "077", "078", "079",
-    "080", "081", "082", "083", "084", "085", "086", "087", "088", "089", "090", "091", "092",
-    "093", "094", "095",
-    "096", "097", "098", "099",
-};
-
 // Display flags
 volatile s_display_flags display;
 
+// LCD memory shadow
+struct lcd_shadow sLcdShadow;
+
+// Partial redraw rate limit
+struct display_rate sDisplayRate;
+
+// Display commands from interrupt context
+struct display_queue sDisplayQueue;
+
+// LCD frame rate and charge pump
+struct lcd_power sLcdPower;
+
 // Global return string for int_to_array function
 unsigned char int_to_array_str[8];
 
@@ -198,13 +253,37 @@ void lcd_init(void)
 {
     // Clear entire display memory
     LCDBMEMCTL |= LCDCLRBM + LCDCLRM;
+    memset(sLcdShadow.mem, 0, sizeof(sLcdShadow.mem));
+    sLcdShadow.dirty = 0;
+    sDisplayRate.last[0] = 0;
+    sDisplayRate.last[1] = 0;
+    sDisplayRate.pending = 0;
+
+    sDisplayQueue.head = 0;
+    sDisplayQueue.tail = 0;
+
+    sLcdShadow.frame = LCD_FRAME_BOTH;
+    sLcdShadow.animation = LCD_ANIMATION_OFF;
+    sLcdShadow.blink_ctl = 0;
+#if (LCD_DOUBLE_BUFFER == 1)
+    sLcdShadow.stale[0] = 0;
+    sLcdShadow.stale[1] = 0;
+    sLcdShadow.shown = 0;
+#endif
 
     // LCD_FREQ = ACLK/16/8 = 256Hz
     // Frame frequency = 256Hz/4 = 64Hz, LCD mux 4, LCD on
     LCDBCTL0 = (LCDDIV0 + LCDDIV1 + LCDDIV2 + LCDDIV3) | (LCDPRE0 + LCDPRE1) | LCD4MUX | LCDON;
+    sLcdPower.mode = LCD_POWER_ACTIVE;
+    sLcdPower.blank = 0;
 
     // LCB_BLK_FREQ = ACLK/8/4096 = 1Hz
+#if (LCD_DOUBLE_BUFFER == 1)
+    // Blinking off, display and blink memory are the two screen buffers
+    LCDBBLKCTL = LCDBLKPRE0 | LCDBLKPRE1 | LCDBLKDIV0 | LCDBLKDIV1 | LCDBLKDIV2;
+#else
     LCDBBLKCTL = LCDBLKPRE0 | LCDBLKPRE1 | LCDBLKDIV0 | LCDBLKDIV1 | LCDBLKDIV2 | LCDBLKMOD0;
+#endif
 
     // I/O to COM outputs
     P5SEL |= (BIT5 | BIT6 | BIT7);
@@ -218,6 +297,72 @@ void lcd_init(void)
     // Charge pump voltage generated internally, internal bias (V2-V4) generation
     LCDBVCTL = LCDCPEN | VLCD_2_72;
 #endif
+    sLcdPower.charge_pump = LCD_CHARGE_PUMP_DEFAULT;
+}
+
+// *************************************************************************************************
+// @fn          lcd_control
+// @brief       Write LCD_B clock and voltage settings. LCDBCTL0 dividers and LCDBVCTL must only
+//              be changed while LCD is off, so the LCD is blank for a moment.
+// @param       unsigned short ctl0        LCDBCTL0 value without LCDON
+//              unsigned short vctl        LCDBVCTL value
+// @return      none
+// *************************************************************************************************
+void lcd_control(unsigned short ctl0, unsigned short vctl)
+{
+    LCDBCTL0 &= ~LCDON;
+    LCDBVCTL = vctl;
+    LCDBCTL0 = sLcdPower.blank ? ctl0 : (ctl0 | LCDON);
+}
+
+// *************************************************************************************************
+// @fn          lcd_power_mode
+// @brief       Select LCD frame rate and charge pump. The LCD_B clock runs in LPM3, 32Hz halves the
+//              LCD switching current while no session is active. A charge pump enabled with
+//              USE_LCD_CHARGE_PUMP only runs during a session, idle VLCD is AVCC.
+// @param       unsigned char mode         LCD_POWER_ACTIVE, LCD_POWER_IDLE
+// @return      none
+// *************************************************************************************************
+void lcd_power_mode(unsigned char mode)
+{
+    unsigned short vctl = 0;
+
+    if (mode == sLcdPower.mode)
+        return;
+
+    sLcdPower.mode = mode;
+    if (mode == LCD_POWER_IDLE)
+    {
+        // LCD_FREQ = ACLK/16/16 = 128Hz, frame frequency = 32Hz
+        sLcdPower.charge_pump = 0;
+        lcd_control((LCDDIV0 + LCDDIV1 + LCDDIV2 + LCDDIV3) | LCDPRE2 | LCD4MUX, vctl);
+    }
+    else
+    {
+        // LCD_FREQ = ACLK/16/8 = 256Hz, frame frequency = 64Hz
+        sLcdPower.charge_pump = LCD_CHARGE_PUMP_DEFAULT;
+        if (sLcdPower.charge_pump)
+            vctl = LCDCPEN | VLCD_2_72;
+        lcd_control((LCDDIV0 + LCDDIV1 + LCDDIV2 + LCDDIV3) | (LCDPRE0 + LCDPRE1) | LCD4MUX, vctl);
+    }
+}
+
+// *************************************************************************************************
+// @fn          lcd_blank
+// @brief       Switch LCD_B off and on. LCD memory and shadow keep the content while blank.
+// @param       unsigned char blank        1 = Blank display, 0 = Show display
+// @return      none
+// *************************************************************************************************
+void lcd_blank(unsigned char blank)
+{
+    if (blank == sLcdPower.blank)
+        return;
+
+    sLcdPower.blank = blank;
+    if (blank)
+        LCDBCTL0 &= ~LCDON;
+    else
+        LCDBCTL0 |= LCDON;
 }
 
 // *************************************************************************************************
@@ -244,8 +389,9 @@ void clear_line(unsigned char line)
 
 // *************************************************************************************************
 // @fn          write_segment
-// @brief       Write to one or multiple LCD segments
-// @param       lcdmem          Pointer to LCD byte memory
+// @brief       Write to one or multiple LCD segments. Only the RAM shadow is changed, lcd_flush()
+//              writes it to LCD memory.
+// @param       lcdmem          Pointer to LCD byte memory (display or blink memory)
 //                              bits            Segments to address
 //                              bitmask         Bitmask for particular display item
 //                              mode            On, off or blink segments
@@ -253,18 +399,254 @@ void clear_line(unsigned char line)
 // *************************************************************************************************
 void write_lcd_mem(unsigned char * lcdmem, unsigned char bits, unsigned char bitmask, unsigned char state)
 {
-    if (state == SEG_ON)
+    unsigned char index;
+    unsigned char last;
+    unsigned char value;
+    unsigned short int_state;
+
+    // Shadow index of LCD memory byte
+    index = (unsigned char) (lcdmem - LCD_MEM_1);
+    last = index;
+    if (index >= LCD_BLINK_MEM_OFFSET)
+    {
+        index = index - LCD_BLINK_MEM_OFFSET + LCD_MEM_SIZE;
+        last = index;
+    }
+    else if (sLcdShadow.frame == LCD_FRAME_B)
+    {
+        // Draw only to blink memory
+        index += LCD_MEM_SIZE;
+        last = index;
+    }
+    else if ((sLcdShadow.frame == LCD_FRAME_BOTH) && (sLcdShadow.animation != LCD_ANIMATION_OFF))
     {
-        // Clear segments before writing
-        *lcdmem = (unsigned char) (*lcdmem & ~bitmask);
+        // Draw to display and blink memory
+        last = index + LCD_MEM_SIZE;
+    }
+
+    // Shadow is also drawn from ISRs
+    int_state = __get_interrupt_state();
+    __disable_interrupt();
+
+    for (; index <= last; index += LCD_MEM_SIZE)
+    {
+        // Clear segments
+        value = (unsigned char) (sLcdShadow.mem[index] & ~bitmask);
 
         // Set visible segments
-        *lcdmem = (unsigned char) (*lcdmem | bits);
+        if (state == SEG_ON)
+            value |= bits;
+
+        if (value != sLcdShadow.mem[index])
+        {
+            sLcdShadow.mem[index] = value;
+            sLcdShadow.dirty |= (1uL << index);
+        }
     }
-    else if (state == SEG_OFF)
+
+    __set_interrupt_state(int_state);
+}
+
+// *************************************************************************************************
+// @fn          lcd_copy_mem
+// @brief       Copy shadow bytes selected by mask to LCD memory.
+// @param       unsigned char * lcdmem     LCD_MEM_1 or blink memory
+//              unsigned char * shadow     Shadow of first byte
+//              unsigned short mask        1 bit per byte to copy
+// @return      none
+// *************************************************************************************************
+void lcd_copy_mem(unsigned char * lcdmem, unsigned char * shadow, unsigned short mask)
+{
+    for (; mask != 0; mask >>= 1, lcdmem++, shadow++)
     {
-        // Clear segments
-        *lcdmem = (unsigned char) (*lcdmem & ~bitmask);
+        if (mask & 1)
+            LCD_MEM_WRITE(lcdmem, *shadow);
+    }
+}
+
+// *************************************************************************************************
+// @fn          lcd_flush
+// @brief       Write LCD memory bytes changed since last flush.
+//              With LCD_DOUBLE_BUFFER the new frame is written to the hidden one of display and
+//              blink memory, then LCDDISP shows it in one register write. Animations need both
+//              memories, then frame A is written to display and frame B to blink memory.
+// @param       none
+// @return      none
+// *************************************************************************************************
+void lcd_flush(void)
+{
+    unsigned long dirty;
+    unsigned short int_state;
+#if (LCD_DOUBLE_BUFFER == 1)
+    unsigned char hidden;
+#endif
+
+    // Take and clear dirty bits; bytes changed from now on are written by next flush
+    int_state = __get_interrupt_state();
+    __disable_interrupt();
+    dirty = sLcdShadow.dirty;
+    sLcdShadow.dirty = 0;
+    __set_interrupt_state(int_state);
+
+#if (LCD_DOUBLE_BUFFER == 1)
+    // Changed screen bytes are outdated in both memories
+    sLcdShadow.stale[0] |= (unsigned short) dirty & LCD_MEM_ALL;
+    sLcdShadow.stale[1] |= (unsigned short) dirty & LCD_MEM_ALL;
+
+    if (sLcdShadow.animation == LCD_ANIMATION_OFF)
+    {
+        // Stop animation first, LCDDISP is under software control in blink mode 00 only
+        if (sLcdShadow.blink_ctl != 0)
+        {
+            LCDBBLKCTL = sLcdShadow.blink_ctl;
+            LCDBMEMCTL &= ~LCDDISP;
+            sLcdShadow.blink_ctl = 0;
+            dirty |= 1;
+        }
+
+        if ((dirty & LCD_MEM_ALL) == 0)
+            return;
+
+        // Draw hidden memory, then show it
+        hidden = sLcdShadow.shown ^ 1;
+        lcd_copy_mem(hidden ? LCD_MEM_1 + LCD_BLINK_MEM_OFFSET : LCD_MEM_1, sLcdShadow.mem,
+                     sLcdShadow.stale[hidden]);
+        sLcdShadow.stale[hidden] = 0;
+
+        if (hidden)
+            LCDBMEMCTL |= LCDDISP;
+        else
+            LCDBMEMCTL &= ~LCDDISP;
+        sLcdShadow.shown = hidden;
+        return;
+    }
+
+    // Frame A to display memory, frame B to blink memory
+    lcd_copy_mem(LCD_MEM_1, sLcdShadow.mem, sLcdShadow.stale[0]);
+    sLcdShadow.stale[0] = 0;
+    lcd_copy_mem(LCD_MEM_1 + LCD_BLINK_MEM_OFFSET, sLcdShadow.mem + LCD_MEM_SIZE,
+                 (unsigned short) (dirty >> LCD_MEM_SIZE));
+
+    // Blink memory no longer holds the screen
+    sLcdShadow.stale[1] = LCD_MEM_ALL;
+    sLcdShadow.shown = 0;
+#else
+    lcd_copy_mem(LCD_MEM_1, sLcdShadow.mem, (unsigned short) dirty & LCD_MEM_ALL);
+    lcd_copy_mem(LCD_MEM_1 + LCD_BLINK_MEM_OFFSET, sLcdShadow.mem + LCD_MEM_SIZE,
+                 (unsigned short) (dirty >> LCD_MEM_SIZE));
+#endif
+
+    // Switch animation after both frames are in LCD memory
+    if (sLcdShadow.blink_ctl != 0)
+    {
+        LCDBBLKCTL = sLcdShadow.blink_ctl;
+        sLcdShadow.blink_ctl = 0;
+    }
+}
+
+// *************************************************************************************************
+// @fn          display_animation
+// @brief       Start or stop a two frame animation run by the LCD_B blink controller. Starting
+//              copies the current screen into blink memory (frame B); draw the differences with
+//              display_frame(LCD_FRAME_B). While running, draws to LCD_FRAME_BOTH change both
+//              frames. Stopping clears blink memory. Takes effect with next lcd_flush().
+// @param       unsigned char animation    LCD_ANIMATION_OFF, LCD_ANIMATION_SLOW, LCD_ANIMATION_FAST
+// @return      none
+// *************************************************************************************************
+void display_animation(unsigned char animation)
+{
+    unsigned char index;
+    unsigned short int_state;
+
+    if (animation == sLcdShadow.animation)
+        return;
+
+    int_state = __get_interrupt_state();
+    __disable_interrupt();
+
+    // Frame B starts as copy of frame A, or is cleared when animation stops
+    for (index = 0; index < LCD_MEM_SIZE; index++)
+        sLcdShadow.mem[index + LCD_MEM_SIZE] = (animation == LCD_ANIMATION_OFF) ? 0 : sLcdShadow.mem[index];
+#if (LCD_DOUBLE_BUFFER == 1)
+    // Blink memory may hold a screen buffer, rewrite frame B completely
+    if (animation != LCD_ANIMATION_OFF)
+        sLcdShadow.dirty |= (unsigned long) LCD_MEM_ALL << LCD_MEM_SIZE;
+#else
+    sLcdShadow.dirty |= (unsigned long) LCD_MEM_ALL << LCD_MEM_SIZE;
+#endif
+
+    // LCD_BLK_FREQ = ACLK/(DIV+1)/2^(PRE+9)
+    if (animation == LCD_ANIMATION_SLOW)
+    {
+        // 1Hz, switch between display and blink memory
+        sLcdShadow.blink_ctl = LCDBLKPRE0 | LCDBLKPRE1 | LCDBLKDIV0 | LCDBLKDIV1 | LCDBLKDIV2 |
+                               LCDBLKMOD0 | LCDBLKMOD1;
+    }
+    else if (animation == LCD_ANIMATION_FAST)
+    {
+        // 4Hz, switch between display and blink memory
+        sLcdShadow.blink_ctl = LCDBLKPRE0 | LCDBLKPRE1 | LCDBLKDIV0 | LCDBLKMOD0 | LCDBLKMOD1;
+    }
+    else
+    {
+#if (LCD_DOUBLE_BUFFER == 1)
+        // Blinking off, LCDDISP selects the shown memory
+        sLcdShadow.blink_ctl = LCDBLKPRE0 | LCDBLKPRE1 | LCDBLKDIV0 | LCDBLKDIV1 | LCDBLKDIV2;
+#else
+        // 1Hz, blink individual segments (blink memory is empty)
+        sLcdShadow.blink_ctl = LCDBLKPRE0 | LCDBLKPRE1 | LCDBLKDIV0 | LCDBLKDIV1 | LCDBLKDIV2 |
+                               LCDBLKMOD0;
+#endif
+    }
+
+    sLcdShadow.animation = animation;
+    sLcdShadow.frame = LCD_FRAME_BOTH;
+
+    __set_interrupt_state(int_state);
+}
+
+// *************************************************************************************************
+// @fn          display_frame
+// @brief       Select animation frame for following draw functions.
+// @param       unsigned char frame        LCD_FRAME_BOTH, LCD_FRAME_A, LCD_FRAME_B
+// @return      none
+// *************************************************************************************************
+void display_frame(unsigned char frame)
+{
+    sLcdShadow.frame = frame;
+}
+
+// *************************************************************************************************
+// @fn          int_to_digits
+// @brief       Division-free integer to digits routine. Writes the lowest "digits" decimal digits
+//              of n to the caller buffer, most significant first, without terminating zero.
+//              Each digit takes one multiply by the reciprocal of 10: q = n * 0xCCCD >> 19 is
+//              exact for all 16-bit n.
+//                              Option to convert leading '0' into whitespace (blanks)
+// @param       unsigned int n                     integer to convert
+//              unsigned char * str                result buffer, at least "digits" bytes
+//              unsigned char digits               number of digits (1-7)
+//              unsigned char blanks               fill up result string with number of
+//                                                 whitespaces instead of leading zeros
+// @return      none
+// *************************************************************************************************
+void int_to_digits(unsigned int n, unsigned char * str, unsigned char digits, unsigned char blanks)
+{
+    unsigned char i;
+    unsigned int q;
+
+    // Calculate digits from least to most significant number
+    for (i = digits; i > 0; i--)
+    {
+        q = (unsigned int) (((unsigned long) n * 0xCCCDu) >> 19);
+        str[i - 1] = (unsigned char) (n - ((q << 3) + (q << 1))) + '0';
+        n = q;
+    }
+
+    // Remove specified number of leading '0', always keep last one
+    for (i = 0; (i < digits - 1) && (blanks > 0) && (str[i] == '0'); i++, blanks--)
+    {
+        str[i] = ' ';
     }
 }
 
@@ -281,9 +663,6 @@ void write_lcd_mem(unsigned char * lcdmem, unsigned char bits, unsigned char bit
 // *************************************************************************************************
 unsigned char *int_to_array(unsigned int n, unsigned char digits, unsigned char blanks)
 {
-    unsigned char i;
-    unsigned char digits1 = digits;
-
     // Preset result string
     memcpy(int_to_array_str, "0000000", 7);
 
@@ -291,33 +670,107 @@ unsigned char *int_to_array(unsigned int n, unsigned char digits, unsigned char
     if ((digits == 0) || (digits > 7))
         return (int_to_array_str);
 
-    // Numbers 0 .. 180 can be copied from int_to_array_conversion_table without conversion
-    if (n <= 180)
+    int_to_digits(n, int_to_array_str, digits, blanks);
+
+    return (int_to_array_str);
+}
+
+// *************************************************************************************************
+// @fn          display_post
+// @brief       Queue display command for main loop. Keeps LCD drawing out of ISRs.
+//              A command already waiting is not queued twice.
+// @param       void (*cmd)(void)          Command
+// @return      none
+// *************************************************************************************************
+void display_post(void (*cmd)(void))
+{
+    unsigned char index;
+    unsigned short int_state;
+
+    int_state = __get_interrupt_state();
+    __disable_interrupt();
+
+    for (index = sDisplayQueue.tail; index != sDisplayQueue.head;
+         index = (index + 1) & (DISPLAY_QUEUE_SIZE - 1))
     {
-        if (digits >= 3)
-        {
-            memcpy(int_to_array_str + (digits - 3), int_to_array_conversion_table[n], 3);
-        }
-        else                    // digits == 1 || 2
-        {
-            memcpy(int_to_array_str, int_to_array_conversion_table[n] + (3 - digits), digits);
-        }
+        if (sDisplayQueue.cmd[index] == cmd)
+            break;
     }
 
-    // Remove specified number of leading '0', always keep last one
-    i = 0;
-    while ((int_to_array_str[i] == '0') && (i < digits1 - 1))
+    // Append if not queued yet, drop command when queue is full
+    if ((index == sDisplayQueue.head) &&
+        (((sDisplayQueue.head + 1) & (DISPLAY_QUEUE_SIZE - 1)) != sDisplayQueue.tail))
+    {
+        sDisplayQueue.cmd[index] = cmd;
+        sDisplayQueue.head = (index + 1) & (DISPLAY_QUEUE_SIZE - 1);
+    }
+
+    __set_interrupt_state(int_state);
+}
+
+// *************************************************************************************************
+// @fn          display_drain
+// @brief       Run queued display commands in order of posting.
+// @param       none
+// @return      none
+// *************************************************************************************************
+void display_drain(void)
+{
+    void (*cmd)(void);
+
+    while (sDisplayQueue.tail != sDisplayQueue.head)
+    {
+        cmd = sDisplayQueue.cmd[sDisplayQueue.tail];
+        sDisplayQueue.tail = (sDisplayQueue.tail + 1) & (DISPLAY_QUEUE_SIZE - 1);
+        cmd();
+    }
+}
+
+// *************************************************************************************************
+// @fn          display_counter_reset
+// @brief       Place counter on LCD. Next display_counter() draws all digits.
+// @param       struct lcd_counter * counter       Counter state
+//              unsigned char segment              Most significant digit (LCD_SEG_L1_3 .. LCD_SEG_L2_0)
+//              unsigned char digits               Number of consecutive digits
+//              unsigned char blanks               Leading zeros shown as blanks
+// @return      none
+// *************************************************************************************************
+void display_counter_reset(struct lcd_counter *counter, unsigned char segment, unsigned char digits,
+                           unsigned char blanks)
+{
+    unsigned char i;
+
+    counter->segment = segment;
+    counter->digits = (digits > LCD_COUNTER_DIGITS_MAX) ? LCD_COUNTER_DIGITS_MAX : digits;
+    counter->blanks = blanks;
+
+    for (i = 0; i < LCD_COUNTER_DIGITS_MAX; i++)
+        counter->shown[i] = 0;
+}
+
+// *************************************************************************************************
+// @fn          display_counter
+// @brief       Display value on counter. Only digits that differ from the LCD are written, one
+//              masked write each. Values with more digits show their lowest digits.
+// @param       struct lcd_counter * counter       Counter state
+//              unsigned int value                 Value to display
+// @return      none
+// *************************************************************************************************
+void display_counter(struct lcd_counter *counter, unsigned int value)
+{
+    unsigned char str[LCD_COUNTER_DIGITS_MAX];
+    unsigned char i;
+
+    int_to_digits(value, str, counter->digits, counter->blanks);
+
+    for (i = 0; i < counter->digits; i++)
     {
-        if (blanks > 0)
+        if (str[i] != counter->shown[i])
         {
-            // Convert only specified number of leading '0'
-            int_to_array_str[i] = ' ';
-            blanks--;
+            display_char(counter->segment + i, str[i], SEG_ON);
+            counter->shown[i] = str[i];
         }
-        i++;
     }
-
-    return (int_to_array_str);
 }
 
 // *************************************************************************************************
@@ -361,7 +814,7 @@ void display_char(unsigned char segment, unsigned char chr, unsigned char mode)
 {
     unsigned char *lcdmem;                 // Pointer to LCD memory
     unsigned char bitmask;                 // Bitmask for character
-    unsigned char bits, bits1;             // Bits to write
+    unsigned char bits;                    // Bits to write
 
     // Write to single 7-segment character
     if ((segment >= LCD_SEG_L1_3) && (segment <= LCD_SEG_L2_DP))
@@ -372,37 +825,20 @@ void display_char(unsigned char segment, unsigned char chr, unsigned char mode)
         // Get bitmask for character from table
         bitmask = segments_bitmask[segment];
 
-        // Get bits from font set
-        if ((chr >= 0x30) && (chr <= 0x5A))
-        {
-            // Use font set
-            bits = lcd_font[chr - 0x30];
-        }
-        else if (chr == 0x2D)
-        {
-            // '-' not in font set
-            bits = BIT1;
-        }
-        else
-        {
-            // Other characters map to ' ' (blank)
+        // Get bits from font set of line, other characters map to ' ' (blank)
+        if ((chr < LCD_FONT_FIRST) || (chr > LCD_FONT_LAST))
             bits = 0;
-        }
+        else if (segment < LCD_SEG_L2_5)
+            bits = lcd_font[chr - LCD_FONT_FIRST];
+        else
+            bits = lcd_font_l2[chr - LCD_FONT_FIRST];
 
-        // When addressing LINE2 7-segment characters need to swap high- and low-nibble,
-        // because LCD COM/SEG assignment is mirrored against LINE1
-        if (segment >= LCD_SEG_L2_5)
+        // When addressing LCD_SEG_L2_5, need to convert ASCII '1' and 'L' to 1 bit,
+        // because LCD COM/SEG assignment is special for this incomplete character
+        if (segment == LCD_SEG_L2_5)
         {
-            bits1 = ((bits << 4) & 0xF0) | ((bits >> 4) & 0x0F);
-            bits = bits1;
-
-            // When addressing LCD_SEG_L2_5, need to convert ASCII '1' and 'L' to 1 bit,
-            // because LCD COM/SEG assignment is special for this incomplete character
-            if (segment == LCD_SEG_L2_5)
-            {
-                if ((chr == '1') || (chr == 'L'))
-                    bits = BIT7;
-            }
+            if ((chr == '1') || (chr == 'L'))
+                bits = BIT7;
         }
 
         // Physically write to LCD memory
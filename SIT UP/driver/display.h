@@ -40,9 +40,9 @@
 
 // Constants defined in library
 extern const unsigned char lcd_font[];
+extern const unsigned char lcd_font_l2[];
 extern const unsigned char *segments_lcdmem[];
 extern const unsigned char segments_bitmask[];
-extern const unsigned char int_to_array_conversion_table[][3];
 
 // Set of display flags
 typedef union
@@ -60,12 +60,29 @@ typedef union
         // Logic module data update flags
         unsigned short update_stopwatch : 1;       // 1 = Stopwatch was updated
         unsigned short update_acceleration : 1;    // 1 = Acceleration data was updated
+        unsigned short update_cadence : 1;         // 1 = Cadence estimate was updated
+        unsigned short update_diagnostics : 1;     // 1 = Diagnostics refresh (1/s)
+
+        // Rate limit
+        unsigned short redraw_pending : 1;         // 1 = Retry line redraws held back before
     } flag;
     unsigned short all_flags;                      // Shortcut to all display flags (for reset)
 } s_display_flags;
 
 extern volatile s_display_flags display;
 
+// Minimum time between partial line redraws (1 tick = 1/32768 sec)
+#define DISPLAY_LINE1_MIN_TICKS                 (0u)                    // Repetition counter
+#define DISPLAY_LINE2_MIN_TICKS                 (CONV_MS_TO_TICKS(100)) // Stopwatch hundredths
+
+// Partial redraws held back by the rate limit
+struct display_rate
+{
+    unsigned long last[2];                 // Timestamp of last LINE1 / LINE2 redraw
+    unsigned char pending;                 // BIT0 = LINE1, BIT1 = LINE2 has new data
+};
+extern struct display_rate sDisplayRate;
+
 // *************************************************************************************************
 // Defines section
 
@@ -82,6 +99,10 @@ extern volatile s_display_flags display;
 #define SEG_OFF                                 (0u)
 #define SEG_ON                                  (1u)
 
+// First and last character in font tables
+#define LCD_FONT_FIRST                          ('-')
+#define LCD_FONT_LAST                           ('Z')
+
 // 7-segment character bit assignments
 #define SEG_A                   (BIT4)
 #define SEG_B                   (BIT5)
@@ -146,19 +167,56 @@ extern volatile s_display_flags display;
 #define LCD_SEG_L2_5_4                          97
 #define LCD_SEG_L2_4_2                          98
 
-// LCD controller memory map
-#define LCD_MEM_1                               ((unsigned char*)0x0A20)
-#define LCD_MEM_2                               ((unsigned char*)0x0A21)
-#define LCD_MEM_3                               ((unsigned char*)0x0A22)
-#define LCD_MEM_4                               ((unsigned char*)0x0A23)
-#define LCD_MEM_5                               ((unsigned char*)0x0A24)
-#define LCD_MEM_6                               ((unsigned char*)0x0A25)
-#define LCD_MEM_7                               ((unsigned char*)0x0A26)
-#define LCD_MEM_8                               ((unsigned char*)0x0A27)
-#define LCD_MEM_9                               ((unsigned char*)0x0A28)
-#define LCD_MEM_10                              ((unsigned char*)0x0A29)
-#define LCD_MEM_11                              ((unsigned char*)0x0A2A)
-#define LCD_MEM_12                              ((unsigned char*)0x0A2B)
+// LCD controller memory map (host builds of the driver may replace LCD_MEM_BASE)
+#ifndef LCD_MEM_BASE
+#define LCD_MEM_BASE                            ((unsigned char*)0x0A20)
+#endif
+#define LCD_MEM_1                               (LCD_MEM_BASE + 0)
+#define LCD_MEM_2                               (LCD_MEM_BASE + 1)
+#define LCD_MEM_3                               (LCD_MEM_BASE + 2)
+#define LCD_MEM_4                               (LCD_MEM_BASE + 3)
+#define LCD_MEM_5                               (LCD_MEM_BASE + 4)
+#define LCD_MEM_6                               (LCD_MEM_BASE + 5)
+#define LCD_MEM_7                               (LCD_MEM_BASE + 6)
+#define LCD_MEM_8                               (LCD_MEM_BASE + 7)
+#define LCD_MEM_9                               (LCD_MEM_BASE + 8)
+#define LCD_MEM_10                              (LCD_MEM_BASE + 9)
+#define LCD_MEM_11                              (LCD_MEM_BASE + 10)
+#define LCD_MEM_12                              (LCD_MEM_BASE + 11)
+
+// Write of one LCD memory byte by lcd_flush (host builds may count writes)
+#ifndef LCD_MEM_WRITE
+#define LCD_MEM_WRITE(lcdmem, value)            (*(lcdmem) = (value))
+#endif
+
+// Display memory size and offset of blink memory
+#define LCD_MEM_SIZE                            (12u)
+#define LCD_MEM_ALL                             (0x0FFFu)  // 1 bit per byte
+#define LCD_BLINK_MEM_OFFSET                    (0x20u)
+
+// 1 = Draw into the hidden one of display and blink memory and switch with LCDDISP
+#define LCD_DOUBLE_BUFFER                       (1)
+
+// LCD power modes: frame rate
+#define LCD_POWER_ACTIVE                        (0u)    // 64Hz, session running
+#define LCD_POWER_IDLE                          (1u)    // 32Hz
+
+// Charge pump setting after lcd_init and during a session
+#ifdef USE_LCD_CHARGE_PUMP
+#define LCD_CHARGE_PUMP_DEFAULT                 (1u)
+#else
+#define LCD_CHARGE_PUMP_DEFAULT                 (0u)
+#endif
+
+// Animations: LCD_B alternates between display memory (frame A) and blink memory (frame B)
+#define LCD_ANIMATION_OFF                       (0u)
+#define LCD_ANIMATION_SLOW                      (1u)       // 1Hz
+#define LCD_ANIMATION_FAST                      (2u)       // 4Hz
+
+// Draw targets while an animation runs
+#define LCD_FRAME_BOTH                          (0u)       // Content common to both frames
+#define LCD_FRAME_A                             (1u)
+#define LCD_FRAME_B                             (2u)
 
 // Memory assignment
 #define LCD_SEG_L1_0_MEM                        (LCD_MEM_6)
@@ -202,14 +260,72 @@ extern volatile s_display_flags display;
 #define LCD_ICON_STOPWATCH_MASK         (BIT3)
 #define LCD_ICON_ALARM_MASK                     (BIT3)
 
+// *************************************************************************************************
+// Global Variable section
+
+// RAM copy of LCD display and blink memory, written to LCD_B by lcd_flush()
+struct lcd_shadow
+{
+    unsigned char mem[2 * LCD_MEM_SIZE];   // LCD_MEM_1 .. LCD_MEM_12, then blink memory
+    volatile unsigned long dirty;          // 1 bit per byte changed since last flush
+    unsigned char frame;                   // Draw target, LCD_FRAME_xxx
+    unsigned char animation;               // Current animation, LCD_ANIMATION_xxx
+    unsigned short blink_ctl;              // LCDBBLKCTL value written by next flush
+#if (LCD_DOUBLE_BUFFER == 1)
+    unsigned short stale[2];               // Bytes of display / blink memory behind the screen
+    unsigned char shown;                   // 0 = display memory shown, 1 = blink memory shown
+#endif
+};
+extern struct lcd_shadow sLcdShadow;
+
+// LCD_B clock and bias generation
+struct lcd_power
+{
+    unsigned char mode;                    // LCD_POWER_ACTIVE, LCD_POWER_IDLE
+    unsigned char charge_pump;             // 1 = VLCD generated by charge pump, 0 = VLCD = AVCC
+    unsigned char blank;                   // 1 = LCD_B off, content kept in LCD memory
+};
+extern struct lcd_power sLcdPower;
+
+// Numeric counter on consecutive 7-segment characters, redraws only changed digits
+#define LCD_COUNTER_DIGITS_MAX                  (5u)
+
+struct lcd_counter
+{
+    unsigned char segment;                 // Most significant digit, e.g. LCD_SEG_L1_2
+    unsigned char digits;                  // Number of digits (1 .. LCD_COUNTER_DIGITS_MAX)
+    unsigned char blanks;                  // Leading zeros shown as blanks
+    unsigned char shown[LCD_COUNTER_DIGITS_MAX];   // Characters on LCD, 0 = redraw
+};
+
+// Display commands posted from interrupt context, run by main loop
+#define DISPLAY_QUEUE_SIZE                      (4u)    // Power of 2
+
+struct display_queue
+{
+    void (*cmd[DISPLAY_QUEUE_SIZE])(void);
+    volatile unsigned char head;           // Next free entry, written by display_post()
+    volatile unsigned char tail;           // Next command to run, written by display_drain()
+};
+extern struct display_queue sDisplayQueue;
+
 // *************************************************************************************************
 // API section
 
 // Physical LCD memory write
 extern void write_lcd_mem(unsigned char * lcdmem, unsigned char bits, unsigned char bitmask, unsigned char state);
 
-// Display init / clear
+// Display init / clear / shadow memory write back
 extern void lcd_init(void);
+extern void lcd_flush(void);
+
+// Runtime power settings
+extern void lcd_power_mode(unsigned char mode);
+extern void lcd_blank(unsigned char blank);
+
+// Hardware animations
+extern void display_animation(unsigned char animation);
+extern void display_frame(unsigned char frame);
 extern void clear_line(unsigned char line);
 
 // Character / symbol draw functions
@@ -217,7 +333,17 @@ extern void display_char(unsigned char segment, unsigned char chr, unsigned char
 extern void display_chars(unsigned char segments, unsigned char * str, unsigned char mode);
 extern void display_symbol(unsigned char symbol, unsigned char mode);
 
+// Deferred display commands
+extern void display_post(void (*cmd)(void));
+extern void display_drain(void);
+
+// Counter widget
+extern void display_counter_reset(struct lcd_counter *counter, unsigned char segment, unsigned char digits,
+                                  unsigned char blanks);
+extern void display_counter(struct lcd_counter *counter, unsigned int value);
+
 // Integer to string conversion
 extern unsigned char *int_to_array(unsigned int n, unsigned char digits, unsigned char blanks);
+extern void int_to_digits(unsigned int n, unsigned char * str, unsigned char digits, unsigned char blanks);
 
 #endif     /*DISPLAY_H_ */
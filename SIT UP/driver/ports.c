@@ -45,6 +45,7 @@
 
 // logic
 #include "stopwatch.h"
+#include "acceleration.h"
 
 // Macro for button IRQ
 #define IRQ_TRIGGERED(flags, bit)               ((flags & bit) == bit)
@@ -56,7 +57,6 @@ volatile struct struct_button sButton;
 
 // *************************************************************************************************
 // Extern section
-extern void (*fptr_Timer0_A3_function)(void);
 
 // *************************************************************************************************
 // @fn          init_buttons
@@ -95,20 +95,22 @@ void init_buttons(void)
 __interrupt void PORT2_ISR(void)
 {
     // Clear flags
-    unsigned char int_flag, int_enable;
+    unsigned char int_flag, int_enable, int_clear;
     unsigned char buzzer = 0;
+    unsigned char wakeup = 1;
 
     // Remember interrupt enable bits
     int_enable = BUTTONS_IE;
 
+    // Store valid interrupt flag, only handled flags are cleared on exit
+    int_flag = BUTTONS_IFG & int_enable;
+    int_clear = int_flag;
+
     if ((!button.flag.star_long) && (!button.flag.num_long))
     {
         // Clear button flags
         button.all_flags = 0;
 
-        // Store valid button interrupt flag
-        int_flag = BUTTONS_IFG & int_enable;
-
         {
             // Debounce buttons
             if ((int_flag & ALL_BUTTONS) != 0)
@@ -120,6 +122,9 @@ __interrupt void PORT2_ISR(void)
 
                 // Debounce delay 1
                 Timer0_A4_Delay(CONV_MS_TO_TICKS(BUTTONS_DEBOUNCE_TIME_IN));
+
+                // Discard button edges from bouncing
+                int_clear |= ALL_BUTTONS;
             }
 
             // ---------------------------------------------------
@@ -129,8 +134,10 @@ __interrupt void PORT2_ISR(void)
                 // Filter bouncing noise
                 if (BUTTON_STAR_IS_PRESSED)
                 {
-                    button.flag.star = 1;
-                    button.flag.star_not_long = 0;
+                    // Short press is reported on release, Timer0_Tick reports a long press
+                    // while the button is held
+                    button.flag.star_not_long = 1;
+                    BUTTONS_IES |= BUTTON_STAR_PIN;
                     // Generate button click
                     buzzer = 1;
                 }
@@ -148,8 +155,10 @@ __interrupt void PORT2_ISR(void)
                 // Filter bouncing noise
                 if (BUTTON_NUM_IS_PRESSED)
                 {
-                    button.flag.num = 1;
-                    button.flag.num_not_long = 0;
+                    // Short press is reported on release, Timer0_Tick reports a long press
+                    // while the button is held
+                    button.flag.num_not_long = 1;
+                    BUTTONS_IES |= BUTTON_NUM_PIN;
                     // Generate button click
                     buzzer = 1;
                 }
@@ -182,22 +191,44 @@ __interrupt void PORT2_ISR(void)
                 }
             }
         }
+    }
 
-        // ---------------------------------------------------
-        // Acceleration sensor IRQ
-        if (IRQ_TRIGGERED(int_flag, AS_INT_PIN))
+    // ---------------------------------------------------
+    // Acceleration sensor IRQ, also while a long button press is pending
+    if (IRQ_TRIGGERED(int_flag, AS_INT_PIN))
+    {
+        // Count data ready edges, and those arriving before the last one was processed
+        if (sAccel.mode == ACCEL_MODE_ON)
         {
-            // Get data from sensor
-            request.flag.acceleration_measurement = 1;
+            sAccelCount.drdy++;
+            if (request.flag.acceleration_measurement)
+                sAccelCount.overrun++;
         }
 
+#if (ACCEL_TIMING == 1)
+        // Stamp data ready for latency statistics
+        accel_timing_drdy();
+#endif
+
+#if (ACCEL_BATCH == 1)
+        // Buffer sample, stay in LPM until batch is complete
+        if (accel_buffer_sample())
+            request.flag.acceleration_measurement = 1;
+        else if ((int_flag & ALL_BUTTONS) == 0)
+            wakeup = 0;
+#else
+        // Get data from sensor
+        request.flag.acceleration_measurement = 1;
+#endif
     }
+
     // Reenable PORT2 IRQ
     __disable_interrupt();
-    BUTTONS_IFG = 0x00;
+    BUTTONS_IFG &= ~int_clear;
     BUTTONS_IE = int_enable;
     __enable_interrupt();
 
     // Exit from LPM3/LPM4 on RETI
-    __bic_SR_register_on_exit(LPM4_bits);
+    if (wakeup)
+        __bic_SR_register_on_exit(LPM4_bits);
 }
@@ -50,6 +50,7 @@
 #include "stopwatch.h"
 #include "display.h"
 #include "acceleration.h"
+#include "menu.h"
 
 // *************************************************************************************************
 // Prototypes section
@@ -57,11 +58,17 @@ void Timer0_Init(void);
 void Timer0_Stop(void);
 void Timer0_A1_Start(void);
 void Timer0_A1_Stop(void);
-void Timer0_A3_Start(unsigned short ticks);
-void Timer0_A3_Stop(void);
+void soft_timer_insert(struct soft_timer * timer);
+void soft_timer_remove(struct soft_timer * timer);
+void soft_timer_program(void);
+void soft_timer_start(struct soft_timer * timer, void (*function)(void), unsigned short ticks,
+                      unsigned short period);
+void soft_timer_stop(struct soft_timer * timer);
+void soft_timer_service(void);
+void Timer0_Tick_Enable(unsigned char enable);
+void Timer0_Tick(void);
 void Timer0_A4_Delay(unsigned short ticks);
-
-void (*fptr_Timer0_A3_function)(void);
+unsigned long Timer0_Timestamp(void);
 
 // *************************************************************************************************
 // Global Variable section
@@ -72,22 +79,19 @@ extern void to_lpm(void);
 
 // *************************************************************************************************
 // @fn          Timer0_Init
-// @brief       Set Timer0 to a period of 1 or 2 sec. IRQ TACCR0 is asserted when timer overflows.
+// @brief       Start Timer0 in continuous mode. 1/1sec tick is a software timer on TACCR3.
 // @param       none
 // @return      none
 // *************************************************************************************************
 void Timer0_Init(void)
 {
-    // Set interrupt frequency to 1Hz
-    TA0CCR0 = 32768 - 1;
-
-    // Enable timer interrupt
-    TA0CCTL0 |= CCIE;
-
     // Clear and start timer now
-    // Continuous mode: Count to 0xFFFF and restart from 0 again - 1sec timing will be generated by
-    // ISR
-    TA0CTL |= TASSEL0 + MC1 + TACLR;
+    // Continuous mode: Count to 0xFFFF and restart from 0 again. Overflow IRQ extends TA0R to a
+    // 32-bit timestamp.
+    sTimer.overflow = 0;
+    sTimer.soft_timers = 0;
+    sTimer.tick.active = 0;
+    TA0CTL |= TASSEL0 + MC1 + TACLR + TAIE;
 }
 
 // *************************************************************************************************
@@ -118,44 +122,158 @@ void Timer0_Stop(void)
 }
 
 // *************************************************************************************************
-// @fn          Timer0_A3_Start
-// @brief       Trigger IRQ every "ticks" microseconds
-// @param       ticks (1 tick = 1/32768 sec)
+// @fn          soft_timer_insert
+// @brief       Insert timer into deadline sorted list. Interrupts must be disabled.
+// @param       struct soft_timer * timer  Timer with deadline set
 // @return      none
 // *************************************************************************************************
-void Timer0_A3_Start(unsigned short ticks)
+void soft_timer_insert(struct soft_timer * timer)
 {
-    unsigned short value = 0;
+    struct soft_timer ** link = &sTimer.soft_timers;
 
-    // Store timer ticks in global variable
-    sTimer.timer0_A3_ticks = ticks;
+    // Behind all timers with the same or an earlier deadline
+    while ((*link != 0) && ((signed long) (timer->deadline - (*link)->deadline) >= 0))
+        link = &(*link)->next;
 
-    // Delay based on current counter value
-    // To make sure this value is correctly read
-    while (value != TA0R)
-        value = TA0R;
-    value += ticks;
+    timer->next = *link;
+    *link = timer;
+    timer->active = 1;
+}
 
-    // Update CCR
-    TA0CCR3 = value;
+// *************************************************************************************************
+// @fn          soft_timer_remove
+// @brief       Remove timer from list. Interrupts must be disabled.
+// @param       struct soft_timer * timer  Timer
+// @return      none
+// *************************************************************************************************
+void soft_timer_remove(struct soft_timer * timer)
+{
+    struct soft_timer ** link = &sTimer.soft_timers;
 
-    // Reset IRQ flag
-    TA0CCTL3 &= ~CCIFG;
+    while ((*link != 0) && (*link != timer))
+        link = &(*link)->next;
 
-    // Enable timer interrupt
+    if (*link == timer)
+        *link = timer->next;
+    timer->active = 0;
+}
+
+// *************************************************************************************************
+// @fn          soft_timer_program
+// @brief       Load TA0CCR3 with first deadline. Interrupts must be disabled.
+// @param       none
+// @return      none
+// *************************************************************************************************
+void soft_timer_program(void)
+{
+    unsigned long now;
+    unsigned long ticks;
+
+    if (sTimer.soft_timers == 0)
+    {
+        // Clear timer interrupt
+        TA0CCTL3 &= ~CCIE;
+        return;
+    }
+
+    now = Timer0_Timestamp();
+    ticks = sTimer.soft_timers->deadline - now;
+
+    // Deadline passed or too close to catch with compare: interrupt now
+    if ((signed long) ticks < 2)
+    {
+        TA0CCTL3 |= CCIE | CCIFG;
+        return;
+    }
+
+    // Far deadline: wake up on the way and program again
+    if (ticks > SOFT_TIMER_MAX_TICKS)
+        ticks = SOFT_TIMER_MAX_TICKS;
+
+    TA0CCR3 = (unsigned short) (now + ticks);
+    TA0CCTL3 &= ~CCIFG;
     TA0CCTL3 |= CCIE;
 }
 
 // *************************************************************************************************
-// @fn          Timer0_A3_Stop
-// @brief       Stop Timer0_A3.
+// @fn          soft_timer_start
+// @brief       (Re)start software timer. Safe to call from timer functions and other ISRs.
+// @param       struct soft_timer * timer  Timer
+//              void (*function)(void)     Called on expiry
+//              unsigned short ticks       First expiry (1 tick = 1/32768 sec)
+//              unsigned short period      Reload ticks for periodic timer, 0 = one-shot
+// @return      none
+// *************************************************************************************************
+void soft_timer_start(struct soft_timer * timer, void (*function)(void), unsigned short ticks,
+                      unsigned short period)
+{
+    unsigned short int_state;
+
+    int_state = __get_interrupt_state();
+    __disable_interrupt();
+
+    if (timer->active)
+        soft_timer_remove(timer);
+
+    timer->function = function;
+    timer->period = period;
+    timer->deadline = Timer0_Timestamp() + ticks;
+    soft_timer_insert(timer);
+    soft_timer_program();
+
+    __set_interrupt_state(int_state);
+}
+
+// *************************************************************************************************
+// @fn          soft_timer_stop
+// @brief       Stop software timer.
+// @param       struct soft_timer * timer  Timer
+// @return      none
+// *************************************************************************************************
+void soft_timer_stop(struct soft_timer * timer)
+{
+    unsigned short int_state;
+
+    int_state = __get_interrupt_state();
+    __disable_interrupt();
+
+    if (timer->active)
+    {
+        soft_timer_remove(timer);
+        soft_timer_program();
+    }
+
+    __set_interrupt_state(int_state);
+}
+
+// *************************************************************************************************
+// @fn          soft_timer_service
+// @brief       Run expired timers from head of list, reload periodic timers. Called by
+//              TIMER0_A1_5_ISR, O(1) per expired one-shot timer.
 // @param       none
 // @return      none
 // *************************************************************************************************
-void Timer0_A3_Stop(void)
+void soft_timer_service(void)
 {
-    // Clear timer interrupt
-    TA0CCTL3 &= ~CCIE;
+    struct soft_timer * timer;
+    unsigned long now = Timer0_Timestamp();
+
+    while ((sTimer.soft_timers != 0) && ((signed long) (sTimer.soft_timers->deadline - now) <= 0))
+    {
+        timer = sTimer.soft_timers;
+        sTimer.soft_timers = timer->next;
+        timer->active = 0;
+
+        // Periodic timers keep their phase, function may stop or restart timer
+        if (timer->period != 0)
+        {
+            timer->deadline += timer->period;
+            soft_timer_insert(timer);
+        }
+        timer->function();
+    }
+
+    soft_timer_program();
 }
 
 // *************************************************************************************************
@@ -203,9 +321,8 @@ void Timer0_A4_Delay(unsigned short ticks)
         // Service watchdog
         WDTCTL = WDTPW + WDTIS__512K + WDTSSEL__ACLK + WDTCNTCL;
 #endif
-        // Redraw stopwatch display
-        if (is_stopwatch())
-            display_stopwatch(LINE2, DISPLAY_LINE_UPDATE_PARTIAL);
+        // No drawing here, the delay also runs inside PORT2_ISR. Stopwatch redraws wait for
+        // display.flag.update_stopwatch in the main loop.
 
         // Check stop condition
         // disable interrupt to prevent flag's change caused by interrupt methods
@@ -217,28 +334,65 @@ void Timer0_A4_Delay(unsigned short ticks)
 }
 
 // *************************************************************************************************
-// @fn          TIMER0_A0_ISR
-// @brief       IRQ handler for TIMER0_A0 IRQ
-//                              Timer0_A0 1/1sec clock tick (serviced by function TIMER0_A0_ISR)
-//                              Timer0_A1 (serviced by function TIMER0_A1_5_ISR)
-//                              Timer0_A2 1/100 sec Stopwatch (serviced by function TIMER0_A1_5_ISR)
-//                              Timer0_A3 Configurable periodic IRQ (serviced by function TIMER0_A1_5_ISR)
-//                              Timer0_A4 One-time delay (serviced by function TIMER0_A1_5_ISR)
+// @fn          Timer0_Timestamp
+// @brief       32-bit ACLK timestamp: overflow count and TA0R. Safe to call from ISRs.
 // @param       none
+// @return      unsigned long      Timestamp (1 tick = 1/32768 sec)
+// *************************************************************************************************
+unsigned long Timer0_Timestamp(void)
+{
+    unsigned short state;
+    unsigned short high;
+    unsigned short low = 0;
+
+    state = __get_interrupt_state();
+    __disable_interrupt();
+
+    // To make sure this value is correctly read
+    while (low != TA0R)
+        low = TA0R;
+    high = sTimer.overflow;
+
+    // Overflow happened, but was not serviced yet
+    if ((TA0CTL & TAIFG) && (low < 0x8000))
+        high++;
+
+    __set_interrupt_state(state);
+
+    return (((unsigned long) high << 16) | low);
+}
+
+// *************************************************************************************************
+// @fn          Timer0_Tick_Enable
+// @brief       Start or stop 1/1sec service. Main loop stops it when no module needs it, so an
+//              idle watch only wakes up for events.
+// @param       unsigned char enable       1 = Tick every second, 0 = No tick
 // @return      none
 // *************************************************************************************************
-#pragma vector = TIMER0_A0_VECTOR
-__interrupt void TIMER0_A0_ISR(void)
+void Timer0_Tick_Enable(unsigned char enable)
 {
-    // Disable IE
-    TA0CCTL0 &= ~CCIE;
-    // Reset IRQ flag
-    TA0CCTL0 &= ~CCIFG;
-    // Add 1 sec to TACCR0 register (IRQ will be asserted at 0x7FFF and 0xFFFF = 1 sec intervals)
-    TA0CCR0 += 32768;
-    // Enable IE
-    TA0CCTL0 |= CCIE;
+    if (enable && !sTimer.tick.active)
+    {
+        soft_timer_start(&sTimer.tick, Timer0_Tick, TIMER0_TICK_TICKS, TIMER0_TICK_TICKS);
+    }
+    else if (!enable && sTimer.tick.active)
+    {
+        soft_timer_stop(&sTimer.tick);
 
+        // Long button press needs consecutive ticks
+        sButton.star_timeout = 0;
+        sButton.num_timeout = 0;
+    }
+}
+
+// *************************************************************************************************
+// @fn          Timer0_Tick
+// @brief       1/1sec service, periodic software timer called by TIMER0_A1_5_ISR.
+// @param       none
+// @return      none
+// *************************************************************************************************
+void Timer0_Tick(void)
+{
     // -------------------------------------------------------------------
     // Service active modules that require 1/s processing
 
@@ -262,6 +416,14 @@ __interrupt void TIMER0_A0_ISR(void)
             request.flag.acceleration_measurement = 1;
     }
 
+    // Refresh diagnostics once per second while they are shown
+    if (ptrMenu_L2 == &menu_L2_Diagnostics)
+        display.flag.update_diagnostics = 1;
+
+    // Retry line redraws held back by the rate limit
+    if (sDisplayRate.pending)
+        display.flag.redraw_pending = 1;
+
     // If a message has to be displayed, set display flag
     if (message.all_flags)
     {
@@ -325,26 +487,21 @@ __interrupt void TIMER0_A0_ISR(void)
             sButton.num_timeout = 0;
         }
     }
-
-    // Exit from LPM3 on RETI
-    _BIC_SR_IRQ(LPM3_bits);
 }
 
 // *************************************************************************************************
 // @fn          Timer0_A1_5_ISR
 // @brief       IRQ handler for timer IRQ.
-//                              Timer0_A0       1/1sec clock tick (serviced by function TIMER0_A0_ISR)
 //                              Timer0_A2       1/100 sec Stopwatch
-//                              Timer0_A3       Configurable periodic IRQ (used by button_repeat and buzzer)
+//                              Timer0_A3       Software timers (used by buzzer and 1/1sec tick)
 //                              Timer0_A4       One-time delay
+//                              Timer0 overflow Timestamp extension, CPU stays in LPM3
 // @param       none
 // @return      none
 // *************************************************************************************************
 #pragma vector = TIMER0_A1_VECTOR
 __interrupt void TIMER0_A1_5_ISR(void)
 {
-    unsigned short value = 0;
-
     switch (TA0IV)
     {
         // Timer0_A2    1/1 or 1/100 sec Stopwatch
@@ -361,22 +518,11 @@ __interrupt void TIMER0_A1_5_ISR(void)
             countdownTimer();
             break;
 
-        // Timer0_A3    Configurable periodic IRQ (used by button_repeat and buzzer)
-        case 0x06:             // Disable IE
-            TA0CCTL3 &= ~CCIE;
-            // Reset IRQ flag
+        // Timer0_A3    Software timers (used by buzzer and 1/1sec tick)
+        case 0x06:             // Reset IRQ flag
             TA0CCTL3 &= ~CCIFG;
-            // Store new value in CCR
-            // To make sure this value is correctly read
-            while (value != TA0R)
-                value = TA0R;
-            value += sTimer.timer0_A3_ticks;
-            // Load CCR register with next capture point
-            TA0CCR3 = value;
-            // Enable timer interrupt
-            TA0CCTL3 |= CCIE;
-            // Call function handler
-            fptr_Timer0_A3_function();
+            // Call expired timer functions, load CCR register with next deadline
+            soft_timer_service();
             break;
 
         // Timer0_A4    One-time delay
@@ -387,6 +533,12 @@ __interrupt void TIMER0_A1_5_ISR(void)
             // Set delay over flag
             sys.flag.delay_over = 1;
             break;
+
+        // Timer0 overflow, extends timestamp
+        case 0x0E:
+            sTimer.overflow++;
+            // Nothing to do for main loop - stay in LPM
+            return;
     }
 
     // Exit from LPM3 on RETI
@@ -41,19 +41,44 @@
 extern void Timer0_Init(void);
 extern void Timer0_Start(void);
 extern void Timer0_Stop(void);
-extern void Timer0_A3_Start(unsigned short ticks);
-extern void Timer0_A3_Stop(void);
 extern void Timer0_A4_Delay(unsigned short ticks);
-
-extern void (*fptr_Timer0_A3_function)(void);
+extern unsigned long Timer0_Timestamp(void);
+extern void Timer0_Tick_Enable(unsigned char enable);
 
 // *************************************************************************************************
 // Defines section
+
+// 1/1sec service period
+#define TIMER0_TICK_TICKS                       (32768u)
+
+// Largest distance between TA0R and TA0CCR3, later deadlines are reached in steps
+#define SOFT_TIMER_MAX_TICKS                    (0x8000u)
+
+// One-shot or periodic software timer, all share Timer0_A3
+struct soft_timer
+{
+    struct soft_timer * next;              // Next active timer, sorted by deadline
+    unsigned long deadline;                // Timestamp of next expiry
+    unsigned short period;                 // Reload ticks, 0 = one-shot
+    unsigned char active;                  // 1 = Timer is in list
+    void (*function)(void);                // Called from TIMER0_A1_5_ISR on expiry
+};
+
 struct timer
 {
-    // Timer0_A3 periodic delay
-    unsigned short timer0_A3_ticks;
+    // Active software timers, earliest deadline first
+    struct soft_timer * soft_timers;
+
+    // 1/1sec service, only active while needed
+    struct soft_timer tick;
+
+    // Timer0 overflows (upper 16 bits of timestamp)
+    unsigned short overflow;
 };
 extern struct timer sTimer;
 
+extern void soft_timer_start(struct soft_timer * timer, void (*function)(void), unsigned short ticks,
+                             unsigned short period);
+extern void soft_timer_stop(struct soft_timer * timer);
+
 #endif                          /*TIMER_H_ */
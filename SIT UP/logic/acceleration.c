@@ -52,11 +52,16 @@
 #include "bmp_as.h"
 #include "as.h"
 #include "buzzer.h"
+#include "timer.h"
 
 #include "stopwatch.h"
 
 // logic
 #include "acceleration.h"
+#include "exercise.h"
+#include "cadence.h"
+#include "gravity.h"
+#include "filter.h"
 
 #include <stdio.h>
 
@@ -64,38 +69,46 @@
 // Global Variable section
 struct accel sAccel;
 
+// Spike rejection for X/Y/Z
+struct median sAccelMedian[3];
+
+// Decimation of X/Y/Z to detector rate
+struct boxcar sAccelBoxcar[3];
+
+// Smoothing for X/Y
+struct kalman sAccelKalman[2];
+
+// Sampling jitter and latency statistics
+struct accel_timing sAccelTiming;
+
+// Data ready, read and processed sample counters
+struct accel_count sAccelCount;
+
+// Samples read by PORT2 ISR, processed in batches
+struct accel_buffer sAccelBuffer;
+
 // Conversion values from data to mgrav taken from BMA250 datasheet (rev 1.05, figure 4)
 const unsigned short bmp_mgrav_per_bit[7] = { 16, 31, 63, 125, 250, 500, 1000 };
 
 unsigned int counter = 0;
-unsigned int upCounter = 0;
-unsigned int downCounter = 0;
-unsigned char tens, ones;
-
-// LCD Segments
-#define LCD_A    BIT4
-#define LCD_B    BIT5
-#define LCD_C    BIT6
-#define LCD_D    BIT7
-#define LCD_F    BIT0
-#define LCD_G    BIT1
-#define LCD_E    BIT2
-#define LCD_H    BIT3
-
-// LCD Segment Mapping
-const unsigned char LCD_Char_Map[] = {
-LCD_A + LCD_B + LCD_C + LCD_D + LCD_E + LCD_F,        // '0' or 'O'
-		LCD_B + LCD_C,                                // '1' or 'I'
-		LCD_A + LCD_B + LCD_D + LCD_E + LCD_G,              // '2' or 'Z'
-		LCD_A + LCD_B + LCD_C + LCD_D + LCD_G,              // '3'
-		LCD_B + LCD_C + LCD_F + LCD_G,                    // '4' or 'y'
-		LCD_A + LCD_C + LCD_D + LCD_F + LCD_G,              // '5' or 'S'
-		LCD_A + LCD_C + LCD_D + LCD_E + LCD_F + LCD_G,        // '6' or 'b'
-		LCD_A + LCD_B + LCD_C,                          // '7'
-		LCD_A + LCD_B + LCD_C + LCD_D + LCD_E + LCD_F + LCD_G,  // '8' or 'B'
-		LCD_A + LCD_B + LCD_C + LCD_D + LCD_F + LCD_G,        // '9' or 'g'
-
-		};
+
+// Repetition counter on LINE1 ("S 05" .. "S999")
+struct lcd_counter sRepCounter;
+
+// *************************************************************************************************
+// Prototypes section
+void accel_reset_filters(void);
+void accel_reset_still(void);
+unsigned char accel_is_still(signed short x, signed short y, signed short z);
+void reset_accel_timing(void);
+void accel_timing_drdy(void);
+void accel_timing_add_sample(unsigned long stamp);
+void accel_reset_buffer(void);
+unsigned char accel_buffer_sample(void);
+void accel_process_sample(unsigned char * xyz);
+void reset_accel_count(void);
+void accel_count_snapshot(struct accel_count * count);
+unsigned char accel_wrist_raised(void);
 
 // *************************************************************************************************
 // Extern section
@@ -116,6 +129,10 @@ void reset_acceleration(void) {
 	// Default mode is off
 	sAccel.mode = ACCEL_MODE_OFF;
 
+	// No sampling statistics yet
+	reset_accel_timing();
+	reset_accel_count();
+
 	counter = 0;
 }
 
@@ -188,61 +205,515 @@ unsigned short convert_acceleration_value_to_mgrav(unsigned char value) {
 }
 
 // *************************************************************************************************
-// @fn          is_acceleration_measurement
-// @brief       Returns 1 if acceleration is currently measured.
+// @fn          convert_acceleration_value_to_signed
+// @brief       Converts measured value to signed 10 * mgrav units
+// @param       unsigned char value        g data from sensor
+// @return      signed short                       Acceleration (10 * mgrav)
+// *************************************************************************************************
+signed short convert_acceleration_value_to_signed(unsigned char value) {
+	signed short result;
+
+	result = convert_acceleration_value_to_mgrav(value) / 10;
+
+	if (!acceleration_value_is_positive(value)) {
+		result = -result;
+	}
+
+	return (result);
+}
+
+// *************************************************************************************************
+// @fn          accel_reset_filters
+// @brief       Refill sample filters with the next sample.
 // @param       none
-// @return      unsigned char              1 = acceleration measurement ongoing
+// @return      none
 // *************************************************************************************************
-unsigned char is_acceleration_measurement(void) {
-	return ((sAccel.mode == ACCEL_MODE_ON) && (sAccel.timeout > 0));
+void accel_reset_filters(void) {
+	reset_median(&sAccelMedian[0]);
+	reset_median(&sAccelMedian[1]);
+	reset_median(&sAccelMedian[2]);
+	reset_boxcar(&sAccelBoxcar[0]);
+	reset_boxcar(&sAccelBoxcar[1]);
+	reset_boxcar(&sAccelBoxcar[2]);
+	reset_kalman(&sAccelKalman[0]);
+	reset_kalman(&sAccelKalman[1]);
 }
 
 // *************************************************************************************************
-// @fn          do_acceleration_measurement
-// @brief       Get sensor data and store in sAccel struct
+// @fn          reset_accel_timing
+// @brief       Clear sampling jitter and latency statistics.
 // @param       none
 // @return      none
 // *************************************************************************************************
-void do_acceleration_measurement(void) {
-	// Get data from sensor
+void reset_accel_timing(void) {
+	sAccelTiming.valid = 0;
+	sAccelTiming.samples = 0;
+	sAccelTiming.interval = 0;
+	sAccelTiming.interval_min = 0xFFFF;
+	sAccelTiming.interval_max = 0;
+	sAccelTiming.mean = (unsigned long) ACCEL_SAMPLE_TICKS << ACCEL_TIMING_SHIFT;
+	sAccelTiming.jitter = 0;
+	sAccelTiming.latency = 0;
+	sAccelTiming.latency_max = 0;
+}
+
+// *************************************************************************************************
+// @fn          accel_timing_drdy
+// @brief       Stamp sensor data ready IRQ. Called from PORT2 ISR.
+// @param       none
+// @return      none
+// *************************************************************************************************
+void accel_timing_drdy(void) {
+	sAccelTiming.drdy = Timer0_Timestamp();
+}
+
+// *************************************************************************************************
+// @fn          accel_timing_add_sample
+// @brief       Update interval, jitter and latency statistics with the data ready timestamp of
+//              the sample being processed.
+// @param       unsigned long stamp        Data ready timestamp of sample
+// @return      none
+// *************************************************************************************************
+void accel_timing_add_sample(unsigned long stamp) {
+	unsigned long delta;
+	unsigned long deviation;
+	unsigned short interval;
+
+	// Data ready to processing latency
+	delta = Timer0_Timestamp() - stamp;
+	sAccelTiming.latency = (delta > 0xFFFF) ? 0xFFFF : (unsigned short) delta;
+	if (sAccelTiming.latency > sAccelTiming.latency_max)
+		sAccelTiming.latency_max = sAccelTiming.latency;
+
+	// First sample of stream has no interval
+	if (!sAccelTiming.valid) {
+		sAccelTiming.last = stamp;
+		sAccelTiming.valid = 1;
+		return;
+	}
+
+	// Sample requested again without new data ready
+	if (stamp == sAccelTiming.last)
+		return;
+
+	delta = stamp - sAccelTiming.last;
+	sAccelTiming.last = stamp;
+	interval = (delta > 0xFFFF) ? 0xFFFF : (unsigned short) delta;
+
+	sAccelTiming.interval = interval;
+	if (interval < sAccelTiming.interval_min)
+		sAccelTiming.interval_min = interval;
+	if (interval > sAccelTiming.interval_max)
+		sAccelTiming.interval_max = interval;
+	if (sAccelTiming.samples < 0xFFFF)
+		sAccelTiming.samples++;
+
+	// Mean interval and mean absolute deviation as EMA in Q4
+	delta = (unsigned long) interval << ACCEL_TIMING_SHIFT;
+	if (delta >= sAccelTiming.mean) {
+		deviation = delta - sAccelTiming.mean;
+		sAccelTiming.mean += deviation >> ACCEL_TIMING_SHIFT;
+	} else {
+		deviation = sAccelTiming.mean - delta;
+		sAccelTiming.mean -= deviation >> ACCEL_TIMING_SHIFT;
+	}
+	if (deviation >= sAccelTiming.jitter)
+		sAccelTiming.jitter += (deviation - sAccelTiming.jitter) >> ACCEL_TIMING_SHIFT;
+	else
+		sAccelTiming.jitter -= (sAccelTiming.jitter - deviation) >> ACCEL_TIMING_SHIFT;
+}
+
+// *************************************************************************************************
+// @fn          reset_accel_count
+// @brief       Clear data ready, read and processed sample counters.
+// @param       none
+// @return      none
+// *************************************************************************************************
+void reset_accel_count(void) {
+	unsigned short int_state;
+
+	// PORT2 ISR increments drdy, overrun and batched reads
+	int_state = __get_interrupt_state();
+	__disable_interrupt();
+	sAccelCount.drdy = 0;
+	sAccelCount.overrun = 0;
+	sAccelCount.read = 0;
+	sAccelCount.processed = 0;
+	__set_interrupt_state(int_state);
+}
+
+// *************************************************************************************************
+// @fn          accel_count_snapshot
+// @brief       Copy sample counters consistently, PORT2 ISR may update them in between.
+// @param       struct accel_count * count         Copy of sAccelCount
+// @return      none
+// *************************************************************************************************
+void accel_count_snapshot(struct accel_count * count) {
+	unsigned short int_state;
+
+	int_state = __get_interrupt_state();
+	__disable_interrupt();
+	*count = sAccelCount;
+	__set_interrupt_state(int_state);
+}
+
+// *************************************************************************************************
+// @fn          accel_reset_buffer
+// @brief       Drop buffered samples.
+// @param       none
+// @return      none
+// *************************************************************************************************
+void accel_reset_buffer(void) {
+	sAccelBuffer.tail = sAccelBuffer.head;
+}
+
+// *************************************************************************************************
+// @fn          accel_buffer_sample
+// @brief       Read sample into buffer. Called from PORT2 ISR on data ready.
+//              The sample is left to the main loop while the sensor is not streaming, the SPI bus
+//              is in use by the main loop (CSN low) or the buffer is full.
+// @param       none
+// @return      unsigned char              1 = wake up main loop to process samples
+// *************************************************************************************************
+unsigned char accel_buffer_sample(void) {
+	unsigned char head = sAccelBuffer.head;
+	unsigned char next = (head + 1) & (ACCEL_BUFFER_SIZE - 1);
+
+	if ((sAccel.mode != ACCEL_MODE_ON) || !bmp_used || ((AS_CSN_OUT & AS_CSN_PIN) == 0)
+			|| (next == sAccelBuffer.tail)) {
+		return (1);
+	}
+
+	bmp_as_get_data(sAccelBuffer.xyz[head]);
+#if (ACCEL_TIMING == 1)
+	sAccelBuffer.stamp[head] = sAccelTiming.drdy;
+#endif
+	sAccelCount.read++;
+	sAccelBuffer.head = next;
+
+	// Wake up once per batch
+	return (((next - sAccelBuffer.tail) & (ACCEL_BUFFER_SIZE - 1)) >= ACCEL_BATCH_SIZE);
+}
+
+// *************************************************************************************************
+// @fn          accel_reset_still
+// @brief       Restart stillness detection.
+// @param       none
+// @return      none
+// *************************************************************************************************
+void accel_reset_still(void) {
+	unsigned char i;
+
+	for (i = 0; i < 3; i++) {
+		sAccel.still_sum[i] = 0;
+		sAccel.still_sumsq[i] = 0;
+	}
+	sAccel.still_samples = 0;
+	sAccel.still_seconds = 0;
+}
+
+// *************************************************************************************************
+// @fn          accel_is_still
+// @brief       Collect samples for a 1s window and compute the variance of each axis at its end,
+//              var = (sumsq - sum^2 / n) / n with n a power of 2. Counts consecutive windows in
+//              which no axis varies more than ACCEL_STILL_VARIANCE.
+// @param       signed short x, y, z       Acceleration (10 * mgrav)
+// @return      unsigned char              1 = still for ACCEL_STILL_TIMEOUT seconds
+// *************************************************************************************************
+unsigned char accel_is_still(signed short x, signed short y, signed short z) {
+	signed short in[3];
+	unsigned long variance;
+	unsigned char moving = 0;
+	unsigned char i;
+
+	in[0] = x;
+	in[1] = y;
+	in[2] = z;
+
+	for (i = 0; i < 3; i++) {
+		sAccel.still_sum[i] += in[i];
+		sAccel.still_sumsq[i] += (signed long) in[i] * in[i];
+	}
+
+	if (++sAccel.still_samples < (1u << ACCEL_STILL_WINDOW_SHIFT)) {
+		return (0);
+	}
+
+	for (i = 0; i < 3; i++) {
+		variance = (sAccel.still_sumsq[i]
+				- (((signed long) sAccel.still_sum[i] * sAccel.still_sum[i])
+						>> ACCEL_STILL_WINDOW_SHIFT)) >> ACCEL_STILL_WINDOW_SHIFT;
+		if (variance > ACCEL_STILL_VARIANCE) {
+			moving = 1;
+		}
+		sAccel.still_sum[i] = 0;
+		sAccel.still_sumsq[i] = 0;
+	}
+	sAccel.still_samples = 0;
+
+	if (moving) {
+		sAccel.still_seconds = 0;
+	} else if (sAccel.still_seconds < ACCEL_STILL_TIMEOUT) {
+		sAccel.still_seconds++;
+	}
+
+	return (sAccel.still_seconds >= ACCEL_STILL_TIMEOUT);
+}
+
+// *************************************************************************************************
+// @fn          suspend_acceleration
+// @brief       Stop data acquisition while the watch is not moved. Sensor stays powered and
+//              wakes the CPU on motion.
+// @param       none
+// @return      none
+// *************************************************************************************************
+void suspend_acceleration(void) {
 	if (bmp_used) {
-		bmp_as_get_data(sAccel.xyz);
+		bmp_as_start_motion();
+	}
+
+	sAccel.mode = ACCEL_MODE_SUSPENDED;
+
+#if (ACCEL_WRIST_WAKE == 1)
+	// Session is over when countdown is not running, blank LCD until wrist raise
+	if (bmp_used && (sStopwatch.state != STOPWATCH_RUN)) {
+		lcd_blank(1);
+	}
+#endif
+}
+
+// *************************************************************************************************
+// @fn          accel_wrist_raised
+// @brief       Check sample after motion wakeup for a display facing up. Sensor keeps running
+//              in low power mode (50ms sleep phase), no data is streamed.
+// @param       none
+// @return      unsigned char              1 = Wrist raised
+// *************************************************************************************************
+unsigned char accel_wrist_raised(void) {
+	unsigned char xyz[3];
+
+	bmp_as_get_data(xyz);
+
+	return ((signed char) xyz[2] >= ACCEL_WRIST_WAKE_Z);
+}
+
+// *************************************************************************************************
+// @fn          resume_acceleration
+// @brief       Return from motion wakeup to normal data acquisition.
+// @param       none
+// @return      none
+// *************************************************************************************************
+void resume_acceleration(void) {
+	if (sAccel.mode != ACCEL_MODE_SUSPENDED) {
+		return;
+	}
+
+	if (bmp_used) {
+		bmp_as_start();
+	}
+
+	// Show display again, draw everything
+	if (sLcdPower.blank) {
+		lcd_blank(0);
+		display.flag.full_update = 1;
 	}
 
-	// Set display update flag
-	display.flag.update_acceleration = 1;
+	sAccel.mode = ACCEL_MODE_ON;
+	accel_reset_filters();
+	accel_reset_still();
+	accel_reset_buffer();
 
+	// Keep statistics, but do not count the suspended time as an interval
+	sAccelTiming.valid = 0;
 }
+
+// *************************************************************************************************
+// @fn          is_acceleration_measurement
+// @brief       Returns 1 if acceleration is currently measured.
+// @param       none
+// @return      unsigned char              1 = acceleration measurement ongoing
+// *************************************************************************************************
+unsigned char is_acceleration_measurement(void) {
+	return ((sAccel.mode == ACCEL_MODE_ON) && (sAccel.timeout > 0));
+}
+
 /****************************************************************************************************/
-/*	This function is to filter the x-axis and y-axis of the accelerometer for more accurate readings*/
-/*	It then set a condition of the incrementing of upCounter and downCounter when a certain x and y	*/
-/*  value is met. When it checks that both upCounter and downCounter is 1, the main counter will 	*/
-/* 	incrementing. If one of them is not met, the upCounter and downCounter will reset to 0. 		*/
-/* 	We then check for the stopwatch state, if it is running, the counter will be able to increment, */
-/*  if not, the counter will not be increment. The counter value will then be display on LCD Line1	*/
-/*  which mod the value of the counter		  														*/
-/* The bmp_mgrav_per_bit is bit-mgrav representation which is used for raw data conversion to mgrav. */
-/* convert_acceleration_value_to_mgrav function is a function that does the conversion of raw data to */
-/* mgrav. During the conversion, if the raw data is a negative value, this function will do the two's */
-/* complement to the raw data before converting it to mgrav value. Afterwards, because of 10 bits	*/
-/* accelerometer and chronos takes in 8 bits MSB while 2 bits LSB is offset, the 					*/
-/* formula (unsigned short) ((accel_data_y * 0.2) + (sAccel.data_y * 0.8)); is used to get the		*/
-/* average value.																					*/
+/*	This function reads the sample of a BMA250 data ready event and records its timing. In batch  */
+/*	mode it instead processes all samples buffered by PORT2 ISR. accel_process_sample() then runs */
+/*	the pipeline for each sample:                                                                 */
+/*	 - raw data is converted to signed 10 * mgrav (two's complement, bmp_mgrav_per_bit)           */
+/*	 - a median of FILTER_MEDIAN_TAPS samples rejects single sample spikes                        */
+/*	 - a boxcar folds ACCEL_DECIMATION sensor samples into one detector sample                    */
+/*	 - the X/Y magnitudes are smoothed by the steady state Kalman filter (FILTER_KALMAN)          */
+/*	 - X/Y/Z feed the gravity tracker, which learns the motion axis (GRAVITY_PROJECTION)          */
+/*	 - the exercise detector places its down/up thresholds inside the running min/max envelope    */
+/*	   of the tilt signal and verifies each rise against the DTW templates of the profile         */
+/*	A repetition increments the counter only while the stopwatch is running. The same signal      */
+/*	feeds the cadence estimator, and a still wrist suspends the sensor.                           */
 /*	Author: Tan Kuan Hong Rollin and Muhammad Khaleef Mun Seng Bin M A Rajkabul					 	*/
 /*	Created in: 28 - Sep 2015																 		*/
 /*	Updated: 28 - Dec 2015																  			*/
 /****************************************************************************************************/
-void display_acceleration(unsigned char line, unsigned char update) {
-	unsigned char *str;
-	unsigned char *str_counter;
-	unsigned char raw_data;
-	unsigned char raw_data_x, raw_data_y;
-	unsigned short accel_data;
+void do_acceleration_measurement(void) {
+	unsigned short int_state;
+#if (ACCEL_TIMING == 1)
+	unsigned long stamp;
+#endif
+#if (ACCEL_BATCH == 1)
+	unsigned char tail;
+#endif
+
+	// Motion wakeup while suspended
+	if (sAccel.mode == ACCEL_MODE_SUSPENDED) {
+#if (ACCEL_WRIST_WAKE == 1)
+		// Blank display: only a wrist raise starts the next session
+		if (sLcdPower.blank && !accel_wrist_raised()) {
+			return;
+		}
+#endif
+		resume_acceleration();
+		return;
+	}
+
+#if (ACCEL_BATCH == 1)
+	// Process all samples buffered by PORT2 ISR
+	if (sAccelBuffer.tail != sAccelBuffer.head) {
+		while ((sAccelBuffer.tail != sAccelBuffer.head) && (sAccel.mode == ACCEL_MODE_ON)) {
+			tail = sAccelBuffer.tail;
+#if (ACCEL_TIMING == 1)
+			accel_timing_add_sample(sAccelBuffer.stamp[tail]);
+#endif
+			accel_process_sample(sAccelBuffer.xyz[tail]);
+			sAccelBuffer.tail = (tail + 1) & (ACCEL_BUFFER_SIZE - 1);
+		}
+		return;
+	}
+#endif
+
+#if (ACCEL_TIMING == 1)
+	// Data ready timestamp is written by PORT2 ISR
+	int_state = __get_interrupt_state();
+	__disable_interrupt();
+	stamp = sAccelTiming.drdy;
+	__set_interrupt_state(int_state);
+
+	accel_timing_add_sample(stamp);
+#endif
+
+	// Get data from sensor
+	if (bmp_used) {
+		bmp_as_get_data(sAccel.xyz);
+
+		// Batched reads are counted by PORT2 ISR
+		int_state = __get_interrupt_state();
+		__disable_interrupt();
+		sAccelCount.read++;
+		__set_interrupt_state(int_state);
+	}
+
+	accel_process_sample(sAccel.xyz);
+}
+
+// *************************************************************************************************
+// @fn          accel_process_sample
+// @brief       Filter one X/Y/Z sample and pass it to the detectors.
+// @param       unsigned char * xyz        Sensor raw data
+// @return      none
+// *************************************************************************************************
+void accel_process_sample(unsigned char * xyz) {
 	unsigned short accel_data_x, accel_data_y;
+	signed short accel_x, accel_y, accel_z;
+#if (FILTER_KALMAN == 1)
+	signed short smooth;
+#endif
+
+	// Keep last raw sample for display
+	sAccel.xyz[0] = xyz[0];
+	sAccel.xyz[1] = xyz[1];
+	sAccel.xyz[2] = xyz[2];
+
+	// Convert X/Y/Z values to signed 10 * mgrav and reject single sample spikes
+	accel_x = median_filter(&sAccelMedian[0], convert_acceleration_value_to_signed(xyz[0]));
+	accel_y = median_filter(&sAccelMedian[1], convert_acceleration_value_to_signed(xyz[1]));
+	accel_z = median_filter(&sAccelMedian[2], convert_acceleration_value_to_signed(xyz[2]));
+
+#if (ACCEL_DECIMATION_SHIFT > 0)
+	// Fold sensor samples into detector rate, all axes complete their block together
+	boxcar_filter(&sAccelBoxcar[0], accel_x, ACCEL_DECIMATION_SHIFT);
+	boxcar_filter(&sAccelBoxcar[1], accel_y, ACCEL_DECIMATION_SHIFT);
+	if (!boxcar_filter(&sAccelBoxcar[2], accel_z, ACCEL_DECIMATION_SHIFT)) {
+		return;
+	}
+	accel_x = sAccelBoxcar[0].out;
+	accel_y = sAccelBoxcar[1].out;
+	accel_z = sAccelBoxcar[2].out;
+#endif
+
+	// Filter X/Y magnitude
+	accel_data_x = (accel_x < 0) ? -accel_x : accel_x;
+	accel_data_y = (accel_y < 0) ? -accel_y : accel_y;
+#if (FILTER_KALMAN == 1)
+	smooth = kalman_filter(&sAccelKalman[0], accel_data_x);
+	accel_data_x = (smooth < 0) ? 0 : smooth;
+	smooth = kalman_filter(&sAccelKalman[1], accel_data_y);
+	accel_data_y = (smooth < 0) ? 0 : smooth;
+#else
+	accel_data_x = (unsigned short) ((accel_data_x * 0.2)
+			+ (sAccel.data_x * 0.8));
+	accel_data_y = (unsigned short) ((accel_data_y * 0.2)
+			+ (sAccel.data_y * 0.8));
+#endif
+
+	// Store average acceleration
+	sAccel.data_x = accel_data_x;
+	sAccel.data_y = accel_data_y;
+
+#if (GRAVITY_PROJECTION == 1)
+	// Track gravity and motion axis on signed X/Y/Z values
+	gravity_add_sample(accel_x, accel_y, accel_z);
+#endif
+
+	// Count repetitions only while the countdown is running
+	if (detect_exercise(accel_data_x, accel_data_y)
+			&& (sStopwatch.state == STOPWATCH_RUN)) {
+		start_buzzer(2, BUZZER_ON_TICKS, BUZZER_OFF_TICKS);
+		counter += 1;
+
+		// Only the repetition counter is drawn, redraw when it changes
+		display.flag.update_acceleration = 1;
+	}
+	sAccelCount.processed++;
 
+	// Repetition rate of the same signal
+	cadence_add_sample(sExercise.signal);
 
-//    int counter=0;
+	// Stop streaming when the watch was put down
+	if (accel_is_still(accel_x, accel_y, accel_z)) {
+		suspend_acceleration();
+	}
+}
 
+// *************************************************************************************************
+// @fn          display_final_count
+// @brief       Flash repetition counter without CPU wakeups: frame B has the digits blanked.
+// @param       none
+// @return      none
+// *************************************************************************************************
+void display_final_count(void) {
+	display_animation(LCD_ANIMATION_SLOW);
+	display_frame(LCD_FRAME_B);
+	display_chars(LCD_SEG_L1_2_0, (unsigned char *) "   ", SEG_ON);
+	display_frame(LCD_FRAME_BOTH);
+}
+
+// *************************************************************************************************
+// @fn          display_acceleration
+// @brief       Display routine. Starts and stops sensor, shows repetition counter.
+// @param       unsigned char line                 LINE1
+//              unsigned char update               DISPLAY_LINE_UPDATE_FULL, DISPLAY_LINE_CLEAR
+// @return      none
+// *************************************************************************************************
+void display_acceleration(unsigned char line, unsigned char update) {
 	// Show warning if acceleration sensor was not initialised properly
 	if (!as_ok)
 	{
@@ -258,6 +729,13 @@ void display_acceleration(unsigned char line, unsigned char update) {
 					sAccel.data_x = 0;
 					sAccel.data_y = 0;
 
+					// Learn gravity and motion axis again
+					reset_gravity();
+					accel_reset_filters();
+					accel_reset_still();
+					accel_reset_buffer();
+					reset_accel_timing();
+
 					// Start sensor
 					if (bmp_used) {
 						bmp_as_start();
@@ -272,93 +750,16 @@ void display_acceleration(unsigned char line, unsigned char update) {
 					// Start with Y-axis values
 					sAccel.view_style = DISPLAY_ACCEL_Y;
 				}
-			}
-		} else if (update == DISPLAY_LINE_UPDATE_PARTIAL) {
-			// Convert X/Y/Z values to mg
-
-			switch (sAccel.view_style) {
-			case DISPLAY_ACCEL_X:
-			case DISPLAY_ACCEL_Y:
-
-				raw_data_x = sAccel.xyz[0];
-				raw_data_y = sAccel.xyz[1];
-				break;
-			default:
-				raw_data = sAccel.xyz[1];
-				break;
-			}
 
-			accel_data = convert_acceleration_value_to_mgrav(raw_data) / 10;
-//            // Filter acceleration
-			accel_data = (unsigned short) ((accel_data * 0.2)
-					+ (sAccel.data * 0.8));
-			sAccel.data = accel_data;
-
-			accel_data_x = convert_acceleration_value_to_mgrav(raw_data_x) / 10;
-			accel_data_x = (unsigned short) ((accel_data_x * 0.2)
-					+ (sAccel.data_x * 0.8));
-			accel_data_y = convert_acceleration_value_to_mgrav(raw_data_y) / 10;
-			accel_data_y = (unsigned short) ((accel_data_y * 0.2)
-					+ (sAccel.data_y * 0.8));
-
-			// Store average acceleration
-
-			sAccel.data_x = accel_data_x;
-			sAccel.data_y = accel_data_y;
-
-			//Down Counter
-			if (downCounter == 0) {
-				if ((accel_data_y >= 70 && accel_data_y <= 80)
-						&& (accel_data_x >= 45 && accel_data_x <= 55)) {
-					downCounter = 1;
-					//counter += 1;
-					__delay_cycles(5000);
-				} else if ((accel_data_y >= 85 && accel_data_y <= 95)
-						&& (accel_data_x >= 20 && accel_data_x <= 30)) {
-					downCounter = 1;
-					//counter += 1;
-					__delay_cycles(5000);
-				} else if ((accel_data_y >= 80 && accel_data_y <= 90)
-						&& (accel_data_x >= 25 && accel_data_x <= 40)) {
-					downCounter = 1;
-					//counter += 1;
-					__delay_cycles(5000);
-				}
-			}
+				// Show selected exercise
+				display_char(LCD_SEG_L1_3, sExercise.profile->symbol, SEG_ON);
 
-			//Up Counter
-			if (downCounter == 1 && upCounter == 0) {
-				if ((accel_data_y >= 45 && accel_data_y <= 55)
-						&& (accel_data_x >= 70 && accel_data_x <= 80)) {
-					upCounter = 1;
-					//counter += 1;
-					__delay_cycles(5000);
-				} else if ((accel_data_y >= 60 && accel_data_y <= 70)
-						&& (accel_data_x >= 45 && accel_data_x <= 55)) {
-					upCounter = 1;
-					//counter += 1;
-					__delay_cycles(5000);
-				} else if ((accel_data_y >= 30 && accel_data_y <= 40)
-						&& (accel_data_x >= 70 && accel_data_x <= 80)) {
-					upCounter = 1;
-					//counter += 1;
-					__delay_cycles(5000);
-				}
+				// Draw all counter digits
+				display_counter_reset(&sRepCounter, LCD_SEG_L1_2, 3, 1);
+				display_counter(&sRepCounter, counter);
 			}
-			if (sStopwatch.state == STOPWATCH_RUN){
-				if (upCounter == 1 && downCounter == 1) {
-					start_buzzer(2, BUZZER_ON_TICKS, BUZZER_OFF_TICKS);
-					counter += 1;
-					upCounter = 0;
-					downCounter = 0;
-				}
-			}
-
-			tens = counter % 100 / 10;
-			ones = counter % 10;
-
-			LCDM4 = LCD_Char_Map[tens];          // Display Character
-			LCDM6 = LCD_Char_Map[ones];          // Display Character
+		} else if (update == DISPLAY_LINE_UPDATE_PARTIAL) {
+			display_counter(&sRepCounter, counter);
 		}
 
 		else if (update == DISPLAY_LINE_CLEAR) {
@@ -369,6 +770,46 @@ void display_acceleration(unsigned char line, unsigned char update) {
 
 			// Clear mode
 			sAccel.mode = ACCEL_MODE_OFF;
+
+			// Clear exercise symbol
+			display_char(LCD_SEG_L1_3, ' ', SEG_ON);
 		}
 	}
 }
+
+// *************************************************************************************************
+// @fn          display_exercise
+// @brief       Select exercise profile on first draw, then display acceleration.
+// @param       unsigned char line                 LINE1
+//              unsigned char update               DISPLAY_LINE_UPDATE_FULL, DISPLAY_LINE_CLEAR
+//              const struct exercise_profile * profile    Profile of this menu item
+// @return      none
+// *************************************************************************************************
+void display_exercise(unsigned char line, unsigned char update, const struct exercise_profile *profile) {
+	// New exercise starts with a cleared counter
+	if ((update == DISPLAY_LINE_UPDATE_FULL) && (sExercise.profile != profile)) {
+		select_exercise(profile);
+		counter = 0;
+	}
+
+	display_acceleration(line, update);
+}
+
+// *************************************************************************************************
+// @fn          display_situp, display_pushup, display_squat
+// @brief       LINE1 display functions of the exercise menu items.
+// @param       unsigned char line                 LINE1
+//              unsigned char update               DISPLAY_LINE_UPDATE_FULL, DISPLAY_LINE_CLEAR
+// @return      none
+// *************************************************************************************************
+void display_situp(unsigned char line, unsigned char update) {
+	display_exercise(line, update, &exercise_situp);
+}
+
+void display_pushup(unsigned char line, unsigned char update) {
+	display_exercise(line, update, &exercise_pushup);
+}
+
+void display_squat(unsigned char line, unsigned char update) {
+	display_exercise(line, update, &exercise_squat);
+}
@@ -40,10 +40,49 @@
 
 #define ACCEL_MODE_OFF          (0u)
 #define ACCEL_MODE_ON           (1u)
+#define ACCEL_MODE_SUSPENDED    (2u)              // Sensor only reports motion
 
 // Stop acceleration measurement after 60 minutes to save battery
 #define ACCEL_MEASUREMENT_TIMEOUT               (60 * 60u)
 
+// Sensor output data rate (BMP_AS_BANDWIDTH = 63Hz)
+#define ACCEL_SAMPLE_RATE_HZ                    (125u)
+
+// Sensor samples averaged into one detector sample (boxcar), shift 0 .. 2, may be set by the build
+// Detector, gravity, cadence and stillness constants follow ACCEL_DETECT_RATE_HZ
+#ifndef ACCEL_DECIMATION_SHIFT
+#define ACCEL_DECIMATION_SHIFT                  (1u)
+#endif
+#define ACCEL_DECIMATION                        (1u << ACCEL_DECIMATION_SHIFT)
+#define ACCEL_DETECT_RATE_HZ                    (ACCEL_SAMPLE_RATE_HZ >> ACCEL_DECIMATION_SHIFT)
+
+// Suspend sensor after this many seconds without movement
+#define ACCEL_STILL_TIMEOUT                     (30u)
+
+// Stillness window (1s of detector samples) and largest variance of a still axis ((10 * mgrav)^2)
+#define ACCEL_STILL_WINDOW_SHIFT                (7u - ACCEL_DECIMATION_SHIFT)
+#define ACCEL_STILL_VARIANCE                    (9u)
+
+// Timestamp samples and keep sampling jitter statistics
+#define ACCEL_TIMING                            (1)
+
+// Timer0 ticks per sample at nominal data rate, EMA weight (1/16) of interval mean and jitter
+#define ACCEL_SAMPLE_TICKS                      (32768u / ACCEL_SAMPLE_RATE_HZ)
+#define ACCEL_TIMING_SHIFT                      (4u)
+
+// Read samples in PORT2 ISR and wake up main loop once per batch
+#define ACCEL_BATCH                             (1)
+
+// Samples per wakeup (125Hz / 8 = 15.6 wakeups/s), buffer size (power of 2)
+#define ACCEL_BATCH_SIZE                        (8u)
+#define ACCEL_BUFFER_SIZE                       (16u)
+
+// Blank LCD while suspended between sessions, motion with display facing up turns it on again
+#define ACCEL_WRIST_WAKE                        (1)
+
+// Smallest Z of a wrist raise in sensor raw data (15.6 mgrav/bit at 2g range: 0.5g)
+#define ACCEL_WRIST_WAKE_Z                      (32)
+
 // *************************************************************************************************
 // Global Variable section
 struct accel
@@ -55,16 +94,68 @@ struct accel
     unsigned short data_y;
     unsigned char view_style;              // Display X/Y/Z values
     unsigned short timeout;                // Timeout
+    signed short still_sum[3];             // Sum of X/Y/Z in stillness window
+    unsigned long still_sumsq[3];          // Sum of squares of X/Y/Z in stillness window
+    unsigned char still_samples;           // Samples in stillness window
+    unsigned char still_seconds;           // Consecutive still windows
 };
 extern struct accel sAccel;
 
+// Sample timing in Timer0 ticks (1 tick = 1/32768 sec)
+struct accel_timing
+{
+    unsigned long drdy;                    // Timestamp of last data ready IRQ
+    unsigned long last;                    // Timestamp of last processed sample
+    unsigned char valid;                   // 1 = last is part of current sample stream
+    unsigned short samples;                // Timed intervals since reset
+    unsigned short interval;               // Last inter-sample interval
+    unsigned short interval_min;
+    unsigned short interval_max;
+    unsigned long mean;                    // Mean interval in Q4
+    unsigned long jitter;                  // Mean absolute deviation from mean in Q4
+    unsigned short latency;                // Last data ready to processing latency
+    unsigned short latency_max;
+};
+extern struct accel_timing sAccelTiming;
+
+// Sample pipeline counters
+struct accel_count
+{
+    unsigned long drdy;                    // Data ready edges seen by PORT2 ISR
+    unsigned long overrun;                 // Data ready edges while previous request was pending
+    unsigned long read;                    // Samples read from sensor
+    unsigned long processed;               // Samples processed by detector
+};
+extern struct accel_count sAccelCount;
+
+// Samples read by PORT2 ISR
+struct accel_buffer
+{
+    unsigned char xyz[ACCEL_BUFFER_SIZE][3];   // Sensor raw data
+    unsigned long stamp[ACCEL_BUFFER_SIZE];    // Data ready timestamps
+    volatile unsigned char head;               // Written by PORT2 ISR
+    volatile unsigned char tail;               // Written by main loop
+};
+extern struct accel_buffer sAccelBuffer;
+
 // *************************************************************************************************
 // Extern section
 extern void reset_acceleration(void);
 extern void mx_acceleration(unsigned char line);
 extern void sx_acceleration(unsigned char line);
 extern void display_acceleration(unsigned char line, unsigned char update);
+extern void display_situp(unsigned char line, unsigned char update);
+extern void display_pushup(unsigned char line, unsigned char update);
+extern void display_squat(unsigned char line, unsigned char update);
+extern void display_final_count(void);
 extern unsigned char is_acceleration_measurement(void);
 extern void do_acceleration_measurement(void);
+extern void suspend_acceleration(void);
+extern void resume_acceleration(void);
+extern void reset_accel_timing(void);
+extern void accel_timing_drdy(void);
+extern void reset_accel_count(void);
+extern void accel_count_snapshot(struct accel_count * count);
+extern unsigned char accel_buffer_sample(void);
 
 #endif                          /*ACCELERATION_H_ */
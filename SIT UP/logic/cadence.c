@@ -0,0 +1,217 @@
+// *************************************************************************************************
+//      Copyright (C) 2009 Texas Instruments Incorporated - http://www.ti.com/
+//
+//        Redistribution and use in source and binary forms, with or without
+//        modification, are permitted provided that the following conditions
+//        are met:
+//
+//          Redistributions of source code must retain the above copyright
+//          notice, this list of conditions and the following disclaimer.
+//
+//          Redistributions in binary form must reproduce the above copyright
+//          notice, this list of conditions and the following disclaimer in the
+//          documentation and/or other materials provided with the
+//          distribution.
+//
+//          Neither the name of Texas Instruments Incorporated nor the names of
+//          its contributors may be used to endorse or promote products derived
+//          from this software without specific prior written permission.
+//
+//        THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+//        "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+//        LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+//        A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+//        OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+//        SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+//        LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+//        DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+//        THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//        (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+//        OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// *************************************************************************************************
+// Repetition rate estimation with a bank of Goertzel filters.
+// *************************************************************************************************
+// Include section
+
+// system
+#include "project.h"
+#include <string.h>
+
+// driver
+#include "display.h"
+
+// logic
+#include "cadence.h"
+#include "stopwatch.h"
+
+// *************************************************************************************************
+// Prototypes section
+void cadence_evaluate(void);
+
+// *************************************************************************************************
+// Global Variable section
+struct cadence sCadence;
+
+// Goertzel coefficients 2 * cos(2 * pi * f / 15.625Hz) in Q14, f = 0.3Hz .. 1.5Hz
+const signed short cadence_coeff[CADENCE_BINS] = {
+    32530, 32345, 32108, 31819, 31478, 31087, 30645,
+    30154, 29614, 29026, 28392, 27711, 26986,
+};
+
+// *************************************************************************************************
+// @fn          reset_cadence
+// @brief       Clear filter bank and cadence estimate.
+// @param       none
+// @return      none
+// *************************************************************************************************
+void reset_cadence(void)
+{
+    unsigned char i;
+
+    for (i = 0; i < CADENCE_BINS; i++)
+    {
+        sCadence.s1[i] = 0;
+        sCadence.s2[i] = 0;
+    }
+    sCadence.dc = 0;
+    sCadence.sum = 0;
+    sCadence.decimation = 0;
+    sCadence.samples = 0;
+    sCadence.rpm = 0;
+}
+
+// *************************************************************************************************
+// @fn          cadence_evaluate
+// @brief       Pick the strongest filter at the end of a block and restart the filter bank.
+// @param       none
+// @return      none
+// *************************************************************************************************
+void cadence_evaluate(void)
+{
+    signed long a, b, power;
+    signed long best_power = CADENCE_MIN_POWER;
+    unsigned char i;
+    unsigned char rpm = 0;
+
+    for (i = 0; i < CADENCE_BINS; i++)
+    {
+        // Power = s1^2 + s2^2 - coeff * s1 * s2, states scaled down to avoid overflow
+        a = sCadence.s1[i] >> 4;
+        b = sCadence.s2[i] >> 4;
+        power = a * a + b * b - ((cadence_coeff[i] * a) >> 14) * b;
+
+        if (power > best_power)
+        {
+            best_power = power;
+            rpm = CADENCE_RPM_FIRST + i * CADENCE_RPM_STEP;
+        }
+
+        sCadence.s1[i] = 0;
+        sCadence.s2[i] = 0;
+    }
+
+    if (rpm != sCadence.rpm)
+    {
+        sCadence.rpm = rpm;
+        display.flag.update_cadence = 1;
+    }
+}
+
+// *************************************************************************************************
+// @fn          cadence_add_sample
+// @brief       Feed one tilt signal sample. Runs the filter bank at the decimated rate, one
+//              multiply-accumulate per filter and sample.
+// @param       signed short signal        Tilt signal (10 * mgrav)
+// @return      none
+// *************************************************************************************************
+void cadence_add_sample(signed short signal)
+{
+    signed short x;
+    signed long s;
+    unsigned char i;
+
+    sCadence.sum += signal;
+
+    if (++sCadence.decimation < CADENCE_DECIMATION)
+        return;
+
+    x = sCadence.sum >> CADENCE_DECIMATION_SHIFT;
+    sCadence.decimation = 0;
+    sCadence.sum = 0;
+
+    // Remove offset with a slow moving average (time constant 2s)
+    sCadence.dc += ((x << 4) - sCadence.dc) >> 5;
+    x -= sCadence.dc >> 4;
+
+    if (x > CADENCE_INPUT_LIMIT)
+        x = CADENCE_INPUT_LIMIT;
+    else if (x < -CADENCE_INPUT_LIMIT)
+        x = -CADENCE_INPUT_LIMIT;
+
+    // s[n] = x[n] + coeff * s[n-1] - s[n-2]
+    for (i = 0; i < CADENCE_BINS; i++)
+    {
+        s = x + ((cadence_coeff[i] * sCadence.s1[i]) >> 14) - sCadence.s2[i];
+        sCadence.s2[i] = sCadence.s1[i];
+        sCadence.s1[i] = s;
+    }
+
+    if (++sCadence.samples >= CADENCE_BLOCK)
+    {
+        sCadence.samples = 0;
+        cadence_evaluate();
+    }
+}
+
+// *************************************************************************************************
+// @fn          mx_cadence
+// @brief       Cadence set routine. Mx restarts the estimate.
+// @param       unsigned char line         LINE2
+// @return      none
+// *************************************************************************************************
+void mx_cadence(unsigned char line)
+{
+    reset_cadence();
+
+    display_cadence(line, DISPLAY_LINE_UPDATE_FULL);
+}
+
+// *************************************************************************************************
+// @fn          sx_cadence
+// @brief       Cadence direct function. Button DOWN still starts/stops the stopwatch.
+// @param       unsigned char line         LINE2
+// @return      none
+// *************************************************************************************************
+void sx_cadence(unsigned char line)
+{
+    sx_stopwatch(line);
+}
+
+// *************************************************************************************************
+// @fn          display_cadence
+// @brief       Display repetitions per minute as "C  rpm", "C  ---" while no cadence is detected.
+// @param       unsigned char line         LINE2
+//              unsigned char update       DISPLAY_LINE_UPDATE_PARTIAL, DISPLAY_LINE_UPDATE_FULL
+// @return      none
+// *************************************************************************************************
+void display_cadence(unsigned char line, unsigned char update)
+{
+    unsigned char str[3];
+
+    if ((update == DISPLAY_LINE_UPDATE_FULL) || (update == DISPLAY_LINE_UPDATE_PARTIAL))
+    {
+        if (update == DISPLAY_LINE_UPDATE_FULL)
+        {
+            display_char(LCD_SEG_L2_5, ' ', SEG_ON);
+            display_char(LCD_SEG_L2_4, 'C', SEG_ON);
+            display_char(LCD_SEG_L2_3, ' ', SEG_ON);
+        }
+
+        if (sCadence.rpm == 0)
+            memcpy(str, "---", 3);
+        else
+            int_to_digits(sCadence.rpm, str, 3, 1);
+
+        display_chars(LCD_SEG_L2_2_0, str, SEG_ON);
+    }
+}
@@ -0,0 +1,84 @@
+// *************************************************************************************************
+//      Copyright (C) 2009 Texas Instruments Incorporated - http://www.ti.com/
+//
+//        Redistribution and use in source and binary forms, with or without
+//        modification, are permitted provided that the following conditions
+//        are met:
+//
+//          Redistributions of source code must retain the above copyright
+//          notice, this list of conditions and the following disclaimer.
+//
+//          Redistributions in binary form must reproduce the above copyright
+//          notice, this list of conditions and the following disclaimer in the
+//          documentation and/or other materials provided with the
+//          distribution.
+//
+//          Neither the name of Texas Instruments Incorporated nor the names of
+//          its contributors may be used to endorse or promote products derived
+//          from this software without specific prior written permission.
+//
+//        THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+//        "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+//        LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+//        A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+//        OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+//        SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+//        LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+//        DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+//        THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//        (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+//        OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// *************************************************************************************************
+
+#ifndef CADENCE_H_
+#define CADENCE_H_
+
+// *************************************************************************************************
+// Include section
+#include <project.h>
+#include "acceleration.h"
+
+// *************************************************************************************************
+// Defines section
+
+// Tilt signal samples averaged into one Goertzel input sample (15.6Hz at any detector rate)
+#define CADENCE_DECIMATION_SHIFT        (3u - ACCEL_DECIMATION_SHIFT)
+#define CADENCE_DECIMATION              (1u << CADENCE_DECIMATION_SHIFT)
+
+// Goertzel block length (64 / 15.6Hz = 4.1s between estimates)
+#define CADENCE_BLOCK                   (64u)
+
+// Filter bank: 0.3Hz .. 1.5Hz in 0.1Hz steps (18 .. 90 reps per minute)
+#define CADENCE_BINS                    (13u)
+#define CADENCE_RPM_FIRST               (18u)
+#define CADENCE_RPM_STEP                (6u)
+
+// Input is clamped to keep Goertzel states inside 32 bits
+#define CADENCE_INPUT_LIMIT             (127)
+
+// Peak power below this level is no cadence (approx. 0.05g amplitude)
+#define CADENCE_MIN_POWER               (64u)
+
+// *************************************************************************************************
+// Global Variable section
+struct cadence
+{
+    signed long s1[CADENCE_BINS];          // Goertzel state s[n-1]
+    signed long s2[CADENCE_BINS];          // Goertzel state s[n-2]
+    signed short dc;                       // Signal offset (Q4)
+    signed short sum;                      // Sum of current decimation block
+    unsigned char decimation;              // Samples accumulated in sum
+    unsigned char samples;                 // Samples processed in current Goertzel block
+    unsigned char rpm;                     // Repetitions per minute, 0 = no cadence detected
+};
+extern struct cadence sCadence;
+
+// *************************************************************************************************
+// Extern section
+extern void reset_cadence(void);
+extern void cadence_add_sample(signed short signal);
+extern void mx_cadence(unsigned char line);
+extern void sx_cadence(unsigned char line);
+extern void display_cadence(unsigned char line, unsigned char update);
+
+#endif                          /*CADENCE_H_ */
@@ -0,0 +1,164 @@
+// *************************************************************************************************
+//      Copyright (C) 2009 Texas Instruments Incorporated - http://www.ti.com/
+//
+//        Redistribution and use in source and binary forms, with or without
+//        modification, are permitted provided that the following conditions
+//        are met:
+//
+//          Redistributions of source code must retain the above copyright
+//          notice, this list of conditions and the following disclaimer.
+//
+//          Redistributions in binary form must reproduce the above copyright
+//          notice, this list of conditions and the following disclaimer in the
+//          documentation and/or other materials provided with the
+//          distribution.
+//
+//          Neither the name of Texas Instruments Incorporated nor the names of
+//          its contributors may be used to endorse or promote products derived
+//          from this software without specific prior written permission.
+//
+//        THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+//        "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+//        LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+//        A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+//        OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+//        SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+//        LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+//        DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+//        THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//        (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+//        OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// *************************************************************************************************
+// Sample pipeline counters and timing statistics on Line2.
+// *************************************************************************************************
+// Include section
+
+// system
+#include "project.h"
+
+// driver
+#include "display.h"
+
+// logic
+#include "diagnostics.h"
+#include "acceleration.h"
+
+// *************************************************************************************************
+// Prototypes section
+unsigned long diagnostics_value(unsigned char page);
+
+// *************************************************************************************************
+// Global Variable section
+struct diagnostics sDiag;
+
+// Page labels shown left of the value
+const unsigned char diag_label[DIAG_PAGES] = { 'D', 'R', 'P', 'L', 'B', 'O', 'J', 'T' };
+
+// *************************************************************************************************
+// @fn          reset_diagnostics
+// @brief       Start with first diagnostics page.
+// @param       none
+// @return      none
+// *************************************************************************************************
+void reset_diagnostics(void)
+{
+    sDiag.page = DIAG_PAGE_DRDY;
+}
+
+// *************************************************************************************************
+// @fn          mx_diagnostics
+// @brief       Diagnostics set routine. Mx clears sample counters and timing statistics.
+// @param       unsigned char line         LINE2
+// @return      none
+// *************************************************************************************************
+void mx_diagnostics(unsigned char line)
+{
+    reset_accel_count();
+    reset_accel_timing();
+
+    display_diagnostics(line, DISPLAY_LINE_UPDATE_FULL);
+}
+
+// *************************************************************************************************
+// @fn          sx_diagnostics
+// @brief       Diagnostics direct function. Button DOWN shows next page.
+// @param       unsigned char line         LINE2
+// @return      none
+// *************************************************************************************************
+void sx_diagnostics(unsigned char line)
+{
+    if (++sDiag.page >= DIAG_PAGES)
+        sDiag.page = DIAG_PAGE_DRDY;
+}
+
+// *************************************************************************************************
+// @fn          diagnostics_value
+// @brief       Value of a diagnostics page.
+// @param       unsigned char page         DIAG_PAGE_xxx
+// @return      unsigned long              Counter or Timer0 ticks
+// *************************************************************************************************
+unsigned long diagnostics_value(unsigned char page)
+{
+    struct accel_count count;
+
+    // PORT2 ISR updates the counters while they are read
+    accel_count_snapshot(&count);
+
+    switch (page)
+    {
+        case DIAG_PAGE_DRDY:
+            return (count.drdy);
+        case DIAG_PAGE_READ:
+            return (count.read);
+        case DIAG_PAGE_PROCESSED:
+            return (count.processed);
+        case DIAG_PAGE_LOST:
+            if (count.drdy > count.read)
+                return (count.drdy - count.read);
+            return (0);
+        case DIAG_PAGE_BACKLOG:
+            // Processed counts detector samples, a boxcar block in progress adds up to
+            // ACCEL_DECIMATION - 1
+            if (count.read > (count.processed << ACCEL_DECIMATION_SHIFT))
+                return (count.read - (count.processed << ACCEL_DECIMATION_SHIFT));
+            return (0);
+        case DIAG_PAGE_OVERRUN:
+            return (count.overrun);
+        case DIAG_PAGE_JITTER:
+            return (sAccelTiming.jitter >> ACCEL_TIMING_SHIFT);
+        case DIAG_PAGE_LATENCY:
+            return (sAccelTiming.latency_max);
+    }
+    return (0);
+}
+
+// *************************************************************************************************
+// @fn          display_diagnostics
+// @brief       Display page label and value as "X 1234". Values above 9999 are shown as "9999".
+// @param       unsigned char line         LINE2
+//              unsigned char update       DISPLAY_LINE_UPDATE_PARTIAL, DISPLAY_LINE_UPDATE_FULL
+// @return      none
+// *************************************************************************************************
+void display_diagnostics(unsigned char line, unsigned char update)
+{
+    unsigned long value;
+    unsigned char str[4];
+
+    if ((update == DISPLAY_LINE_UPDATE_FULL) || (update == DISPLAY_LINE_UPDATE_PARTIAL))
+    {
+        if (update == DISPLAY_LINE_UPDATE_FULL)
+        {
+            display_char(LCD_SEG_L2_5, ' ', SEG_ON);
+        }
+
+        display_char(LCD_SEG_L2_4, diag_label[sDiag.page], SEG_ON);
+
+        // Clamp instead of a 32-bit modulo, int_to_digits takes 16-bit values
+        value = diagnostics_value(sDiag.page);
+        if (value > 9999)
+            value = 9999;
+
+        int_to_digits((unsigned int) value, str, 4, 3);
+        display_chars(LCD_SEG_L2_3_0, str, SEG_ON);
+    }
+}
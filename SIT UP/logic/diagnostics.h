@@ -0,0 +1,69 @@
+// *************************************************************************************************
+//      Copyright (C) 2009 Texas Instruments Incorporated - http://www.ti.com/
+//
+//        Redistribution and use in source and binary forms, with or without
+//        modification, are permitted provided that the following conditions
+//        are met:
+//
+//          Redistributions of source code must retain the above copyright
+//          notice, this list of conditions and the following disclaimer.
+//
+//          Redistributions in binary form must reproduce the above copyright
+//          notice, this list of conditions and the following disclaimer in the
+//          documentation and/or other materials provided with the
+//          distribution.
+//
+//          Neither the name of Texas Instruments Incorporated nor the names of
+//          its contributors may be used to endorse or promote products derived
+//          from this software without specific prior written permission.
+//
+//        THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+//        "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+//        LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+//        A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+//        OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+//        SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+//        LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+//        DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+//        THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//        (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+//        OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// *************************************************************************************************
+
+#ifndef DIAGNOSTICS_H_
+#define DIAGNOSTICS_H_
+
+// *************************************************************************************************
+// Include section
+#include <project.h>
+
+// *************************************************************************************************
+// Defines section
+
+// Diagnostics pages, DOWN button advances
+#define DIAG_PAGE_DRDY                  (0u)       // "D" Data ready edges seen by PORT2 ISR
+#define DIAG_PAGE_READ                  (1u)       // "R" Samples read from sensor
+#define DIAG_PAGE_PROCESSED             (2u)       // "P" Detector samples (decimated)
+#define DIAG_PAGE_LOST                  (3u)       // "L" Data ready edges without sensor read
+#define DIAG_PAGE_BACKLOG               (4u)       // "B" Samples read but not yet processed
+#define DIAG_PAGE_OVERRUN               (5u)       // "O" Data ready while previous request pending
+#define DIAG_PAGE_JITTER                (6u)       // "J" Sample interval jitter in Timer0 ticks
+#define DIAG_PAGE_LATENCY               (7u)       // "T" Largest data ready latency in Timer0 ticks
+#define DIAG_PAGES                      (8u)
+
+// *************************************************************************************************
+// Global Variable section
+struct diagnostics
+{
+    unsigned char page;                    // Current page, DIAG_PAGE_xxx
+};
+extern struct diagnostics sDiag;
+
+// *************************************************************************************************
+// Extern section
+extern void reset_diagnostics(void);
+extern void mx_diagnostics(unsigned char line);
+extern void sx_diagnostics(unsigned char line);
+extern void display_diagnostics(unsigned char line, unsigned char update);
+
+#endif                          /*DIAGNOSTICS_H_ */
@@ -0,0 +1,205 @@
+// *************************************************************************************************
+//      Copyright (C) 2009 Texas Instruments Incorporated - http://www.ti.com/
+//
+//        Redistribution and use in source and binary forms, with or without
+//        modification, are permitted provided that the following conditions
+//        are met:
+//
+//          Redistributions of source code must retain the above copyright
+//          notice, this list of conditions and the following disclaimer.
+//
+//          Redistributions in binary form must reproduce the above copyright
+//          notice, this list of conditions and the following disclaimer in the
+//          documentation and/or other materials provided with the
+//          distribution.
+//
+//          Neither the name of Texas Instruments Incorporated nor the names of
+//          its contributors may be used to endorse or promote products derived
+//          from this software without specific prior written permission.
+//
+//        THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+//        "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+//        LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+//        A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+//        OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+//        SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+//        LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+//        DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+//        THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//        (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+//        OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// *************************************************************************************************
+// Banded fixed-point dynamic time warping matcher for exercise repetitions.
+// *************************************************************************************************
+// Include section
+
+// system
+#include "project.h"
+
+// logic
+#include "dtw.h"
+
+// *************************************************************************************************
+// Global Variable section
+struct dtw sDtw;
+
+// Two rows of the cost matrix, kept out of the stack
+static unsigned short dtw_row[2][DTW_LENGTH];
+
+// Last second of fast (1.8s), medium (2.6s) and slow (3.4s) repetitions: down phase, then the
+// rise up to the up threshold. The matcher removes the window mean but does not scale, so shapes
+// are compared in absolute units (10 * mgrav).
+const struct dtw_template dtw_templates_rise[DTW_TEMPLATES_RISE] = {
+    {{ -15,  -7,   0,   5,   7,   8,   8,   8,   8,   8,   7,   8,   7,   7,   7,   7,
+         7,   7,   7,   6,   6,   6,   6,   6,   6,   3,  -1,  -8, -16, -25, -34, -43 }},
+    {{   9,   9,   9,   9,   9,   9,   9,   8,   8,   8,   8,   8,   8,   8,   8,   7,
+         7,   7,   7,   7,   7,   7,   6,   2,  -1,  -7, -13, -19, -25, -31, -37, -44 }},
+    {{  11,  11,  11,  11,  11,  11,  11,  10,  11,  10,  10,  10,   9,   9,   9,   9,
+         9,   9,   9,   9,   7,   4,   0,  -4,  -8, -13, -18, -22, -27, -32, -36, -41 }},
+};
+
+// *************************************************************************************************
+// @fn          reset_dtw
+// @brief       Clear match window.
+// @param       none
+// @return      none
+// *************************************************************************************************
+void reset_dtw(void)
+{
+    unsigned char i;
+
+    for (i = 0; i < DTW_LENGTH; i++)
+        sDtw.window[i] = 0;
+    sDtw.head = 0;
+    sDtw.decimation = 0;
+    sDtw.sum = 0;
+}
+
+// *************************************************************************************************
+// @fn          dtw_add_sample
+// @brief       Average DTW_DECIMATION tilt signal samples into the next window point.
+// @param       signed short signal        Tilt signal
+// @return      none
+// *************************************************************************************************
+void dtw_add_sample(signed short signal)
+{
+    sDtw.sum += signal;
+
+    if (++sDtw.decimation < DTW_DECIMATION)
+        return;
+
+    // Overwrite oldest point
+    sDtw.window[sDtw.head] = sDtw.sum >> DTW_DECIMATION_SHIFT;
+    sDtw.head = (sDtw.head + 1) & (DTW_LENGTH - 1);
+    sDtw.decimation = 0;
+    sDtw.sum = 0;
+}
+
+// *************************************************************************************************
+// @fn          dtw_distance
+// @brief       Banded DTW distance between the mean free window and a template. Gives up as soon
+//              as no path inside the band can stay below limit.
+// @param       const struct dtw_template * tmpl      Template to compare
+//              unsigned short limit                  Abandon threshold
+// @return      unsigned short                        Distance, DTW_INFINITY if abandoned
+// *************************************************************************************************
+unsigned short dtw_distance(const struct dtw_template *tmpl, unsigned short limit)
+{
+    unsigned short *prev = dtw_row[0];
+    unsigned short *cur = dtw_row[1];
+    unsigned short *swap;
+    unsigned short best, cost, row_min;
+    signed short mean = 0;
+    signed short value, diff;
+    unsigned char i, j, j_min, j_max, w;
+
+    // Remove offset of the window, templates are zero mean
+    for (i = 0; i < DTW_LENGTH; i++)
+        mean += sDtw.window[i];
+    mean >>= DTW_LENGTH_SHIFT;
+
+    // Cells outside the band are never written and keep DTW_INFINITY
+    for (j = 0; j < DTW_LENGTH; j++)
+    {
+        dtw_row[0][j] = DTW_INFINITY;
+        dtw_row[1][j] = DTW_INFINITY;
+    }
+
+    for (i = 0; i < DTW_LENGTH; i++)
+    {
+        j_min = (i > DTW_BAND) ? i - DTW_BAND : 0;
+        j_max = (i + DTW_BAND < DTW_LENGTH - 1) ? i + DTW_BAND : DTW_LENGTH - 1;
+
+        // Left neighbour of the band may still hold a value from two rows ago
+        if (j_min > 0)
+            cur[j_min - 1] = DTW_INFINITY;
+
+        // Window point i, oldest first, loaded once per row
+        w = (sDtw.head + i) & (DTW_LENGTH - 1);
+        value = sDtw.window[w] - mean;
+
+        row_min = DTW_INFINITY;
+        for (j = j_min; j <= j_max; j++)
+        {
+            diff = value - tmpl->point[j];
+            cost = (diff < 0) ? -diff : diff;
+
+            // Cheapest predecessor: match, insertion or deletion
+            if (i == 0)
+            {
+                best = (j == 0) ? 0 : cur[j - 1];
+            }
+            else
+            {
+                best = prev[j];
+                if (j > 0)
+                {
+                    if (prev[j - 1] < best)
+                        best = prev[j - 1];
+                    if (cur[j - 1] < best)
+                        best = cur[j - 1];
+                }
+            }
+
+            // Saturate instead of overflow
+            if (best >= DTW_INFINITY - cost)
+                cur[j] = DTW_INFINITY;
+            else
+                cur[j] = best + cost;
+
+            if (cur[j] < row_min)
+                row_min = cur[j];
+        }
+
+        // Costs only grow along a path - abandon early
+        if (row_min > limit)
+            return (DTW_INFINITY);
+
+        swap = prev;
+        prev = cur;
+        cur = swap;
+    }
+
+    return (prev[DTW_LENGTH - 1]);
+}
+
+// *************************************************************************************************
+// @fn          dtw_match
+// @brief       Check if the window matches any of the given templates. Worst case timing is
+//              listed with DTW_BAND in dtw.h.
+// @param       const struct dtw_template * tmpl      First template
+//              unsigned char count                   Number of templates
+//              unsigned short threshold              Maximum accepted distance
+// @return      unsigned char                         1 = window matches a template
+// *************************************************************************************************
+unsigned char dtw_match(const struct dtw_template *tmpl, unsigned char count,
+                        unsigned short threshold)
+{
+    while (count--)
+    {
+        if (dtw_distance(tmpl++, threshold) <= threshold)
+            return (1);
+    }
+
+    return (0);
+}
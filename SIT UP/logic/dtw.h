@@ -0,0 +1,98 @@
+// *************************************************************************************************
+//      Copyright (C) 2009 Texas Instruments Incorporated - http://www.ti.com/
+//
+//        Redistribution and use in source and binary forms, with or without
+//        modification, are permitted provided that the following conditions
+//        are met:
+//
+//          Redistributions of source code must retain the above copyright
+//          notice, this list of conditions and the following disclaimer.
+//
+//          Redistributions in binary form must reproduce the above copyright
+//          notice, this list of conditions and the following disclaimer in the
+//          documentation and/or other materials provided with the
+//          distribution.
+//
+//          Neither the name of Texas Instruments Incorporated nor the names of
+//          its contributors may be used to endorse or promote products derived
+//          from this software without specific prior written permission.
+//
+//        THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+//        "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+//        LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+//        A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+//        OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+//        SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+//        LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+//        DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+//        THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//        (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+//        OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// *************************************************************************************************
+
+#ifndef DTW_H_
+#define DTW_H_
+
+// *************************************************************************************************
+// Include section
+#include <project.h>
+#include "acceleration.h"
+
+// *************************************************************************************************
+// Defines section
+
+// 1 = Verify repetitions of the threshold detector with the DTW template matcher
+#define DTW_MATCHER                     (1)
+
+// Number of points in the match window (power of 2)
+#define DTW_LENGTH                      (32u)
+#define DTW_LENGTH_SHIFT                (5u)
+
+// Tilt signal samples averaged into one window point (31Hz at any detector rate, window = 1s)
+#define DTW_DECIMATION_SHIFT            (2u - ACCEL_DECIMATION_SHIFT)
+#define DTW_DECIMATION                  (1u << DTW_DECIMATION_SHIFT)
+
+// Sakoe-Chiba band width (window points)
+//
+// The band leaves 268 of the 32 x 32 cells per template. Worst case of dtw_match (3 templates,
+// no early abandon) at 12MHz MCLK, from the MSP430X instruction cycle table applied to the
+// 33 instructions of the inner loop (not measured on target):
+//   typical  54 cycles per cell                  ~ 50000 cycles =  4.2ms
+//   ceiling  6 cycles for every instruction     ~ 176000 cycles = 14.7ms
+// Both stay below the 16ms detector period at 62.5Hz. At 125Hz (8ms) only the typical case fits.
+#define DTW_BAND                        (4u)
+
+// Distance of a failed or abandoned match
+#define DTW_INFINITY                    (0xFFFFu)
+
+// *************************************************************************************************
+// Global Variable section
+
+// Repetition template, zero mean, stored in flash
+struct dtw_template
+{
+    signed char point[DTW_LENGTH];
+};
+
+struct dtw
+{
+    signed short window[DTW_LENGTH];       // Decimated tilt signal, ring buffer
+    unsigned char head;                    // Index of oldest window point
+    unsigned char decimation;              // Samples accumulated in sum
+    signed short sum;                      // Sum of current decimation block
+};
+extern struct dtw sDtw;
+
+// Templates of a single repetition (down phase -> up phase)
+extern const struct dtw_template dtw_templates_rise[];
+#define DTW_TEMPLATES_RISE              (3u)
+
+// *************************************************************************************************
+// Extern section
+extern void reset_dtw(void);
+extern void dtw_add_sample(signed short signal);
+extern unsigned short dtw_distance(const struct dtw_template *tmpl, unsigned short limit);
+extern unsigned char dtw_match(const struct dtw_template *tmpl, unsigned char count,
+                               unsigned short threshold);
+
+#endif                          /*DTW_H_ */
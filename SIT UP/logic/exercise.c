@@ -0,0 +1,263 @@
+// *************************************************************************************************
+//      Copyright (C) 2009 Texas Instruments Incorporated - http://www.ti.com/
+//
+//        Redistribution and use in source and binary forms, with or without
+//        modification, are permitted provided that the following conditions
+//        are met:
+//
+//          Redistributions of source code must retain the above copyright
+//          notice, this list of conditions and the following disclaimer.
+//
+//          Redistributions in binary form must reproduce the above copyright
+//          notice, this list of conditions and the following disclaimer in the
+//          documentation and/or other materials provided with the
+//          distribution.
+//
+//          Neither the name of Texas Instruments Incorporated nor the names of
+//          its contributors may be used to endorse or promote products derived
+//          from this software without specific prior written permission.
+//
+//        THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+//        "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+//        LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+//        A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+//        OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+//        SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+//        LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+//        DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+//        THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//        (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+//        OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// *************************************************************************************************
+// Exercise repetition detector.
+// *************************************************************************************************
+// Include section
+
+// system
+#include "project.h"
+
+// logic
+#include "acceleration.h"
+#include "exercise.h"
+#include "dtw.h"
+
+// *************************************************************************************************
+// Defines section
+
+// Build fails if CONV_MS_TO_SAMPLES multiplies in int: 3000 ms at 125 Hz needs 375000
+typedef char exercise_conv_check[(sizeof(CONV_MS_TO_SAMPLES(0)) >= sizeof(unsigned long)) ? 1 : -1];
+
+// *************************************************************************************************
+// Prototypes section
+void exercise_reset_envelope(signed short signal);
+void exercise_track_envelope(signed short signal);
+
+// *************************************************************************************************
+// Global Variable section
+struct exercise sExercise;
+
+// Sit-up: X/Y windows taken from the original sit-up detector, down phase y - x >= 20, up phase
+// y - x <= 10
+const struct exercise_profile exercise_situp = {
+    'S',                                   // symbol
+    -1, 1,                                 // weight_x, weight_y
+    20, 10,                                // down_threshold, up_threshold
+    CONV_MS_TO_SAMPLES(100),               // min_rise_samples
+    CONV_MS_TO_SAMPLES(3000),              // max_rise_samples
+    dtw_templates_rise,                    // templates
+    DTW_TEMPLATES_RISE,                    // num_templates
+    400,                                   // dtw_threshold
+    20, -20,                               // proj_down_threshold, proj_up_threshold
+    20,                                    // min_span
+};
+
+// Push-up: forearm tilt on the Y-axis, values are a starting point for tuning
+const struct exercise_profile exercise_pushup = {
+    'P',                                   // symbol
+    0, 1,                                  // weight_x, weight_y
+    60, 40,                                // down_threshold, up_threshold
+    CONV_MS_TO_SAMPLES(150),               // min_rise_samples
+    CONV_MS_TO_SAMPLES(2500),              // max_rise_samples
+    0,                                     // templates, none recorded yet: no DTW verification
+    0,                                     // num_templates
+    0,                                     // dtw_threshold
+    20, -20,                               // proj_down_threshold, proj_up_threshold
+    30,                                    // min_span
+};
+
+// Squat: arms stretched forward, tilt on the X-axis, values are a starting point for tuning
+const struct exercise_profile exercise_squat = {
+    'A',                                   // symbol
+    1, 0,                                  // weight_x, weight_y
+    70, 50,                                // down_threshold, up_threshold
+    CONV_MS_TO_SAMPLES(200),               // min_rise_samples
+    CONV_MS_TO_SAMPLES(4000),              // max_rise_samples
+    0,                                     // templates, none recorded yet: no DTW verification
+    0,                                     // num_templates
+    0,                                     // dtw_threshold
+    20, -20,                               // proj_down_threshold, proj_up_threshold
+    30,                                    // min_span
+};
+
+// *************************************************************************************************
+// @fn          exercise_reset_envelope
+// @brief       Collapse min/max envelope onto signal.
+// @param       signed short signal        Tilt signal
+// @return      none
+// *************************************************************************************************
+void exercise_reset_envelope(signed short signal)
+{
+    sExercise.env_max = (signed long) signal << EXERCISE_ENVELOPE_FRAC;
+    sExercise.env_min = (signed long) signal << EXERCISE_ENVELOPE_FRAC;
+}
+
+// *************************************************************************************************
+// @fn          exercise_track_envelope
+// @brief       Follow peaks and valleys immediately, decay towards the signal in between.
+// @param       signed short signal        Tilt signal
+// @return      none
+// *************************************************************************************************
+void exercise_track_envelope(signed short signal)
+{
+    signed long value = (signed long) signal << EXERCISE_ENVELOPE_FRAC;
+
+    if (value > sExercise.env_max)
+        sExercise.env_max = value;
+    else
+        sExercise.env_max -= (sExercise.env_max - value) >> EXERCISE_ENVELOPE_SHIFT;
+
+    if (value < sExercise.env_min)
+        sExercise.env_min = value;
+    else
+        sExercise.env_min += (value - sExercise.env_min) >> EXERCISE_ENVELOPE_SHIFT;
+}
+
+// *************************************************************************************************
+// @fn          reset_exercise
+// @brief       Select default profile and reset detector state.
+// @param       none
+// @return      none
+// *************************************************************************************************
+void reset_exercise(void)
+{
+    select_exercise(&exercise_situp);
+}
+
+// *************************************************************************************************
+// @fn          select_exercise
+// @brief       Switch detector to a new profile. Discards a partially detected repetition.
+// @param       const struct exercise_profile * profile        Profile to use
+// @return      none
+// *************************************************************************************************
+void select_exercise(const struct exercise_profile *profile)
+{
+    sExercise.profile = profile;
+    sExercise.phase = EXERCISE_PHASE_IDLE;
+    sExercise.samples = 0;
+    sExercise.projected = 0;
+    exercise_reset_envelope(0);
+    reset_dtw();
+    reset_gravity();
+}
+
+// *************************************************************************************************
+// @fn          detect_exercise
+// @brief       Run selected profile on one filtered sample.
+// @param       unsigned short x           Filtered X-axis acceleration (10 * mgrav)
+//              unsigned short y           Filtered Y-axis acceleration (10 * mgrav)
+// @return      unsigned char              1 = repetition completed with this sample
+// *************************************************************************************************
+unsigned char detect_exercise(unsigned short x, unsigned short y)
+{
+    const struct exercise_profile *profile = sExercise.profile;
+    signed short signal;
+    signed short down_threshold = profile->down_threshold;
+    signed short up_threshold = profile->up_threshold;
+    unsigned char projected = 0;
+#if (EXERCISE_ADAPTIVE == 1)
+    signed short env_min;
+    signed short span;
+#endif
+
+#if (GRAVITY_PROJECTION == 1)
+    if (sGravity.state == GRAVITY_LOCKED)
+    {
+        // Orientation independent signal
+        signal = sGravity.projection;
+        down_threshold = profile->proj_down_threshold;
+        up_threshold = profile->proj_up_threshold;
+        projected = 1;
+    }
+    else
+#endif
+    {
+        // Fixed orientation signal
+        signal = profile->weight_x * (signed short) x + profile->weight_y * (signed short) y;
+    }
+    sExercise.signal = signal;
+
+#if (EXERCISE_ADAPTIVE == 1)
+    // Envelope of the old signal is meaningless after switching to the projection
+    if (projected != sExercise.projected)
+    {
+        sExercise.projected = projected;
+        sExercise.phase = EXERCISE_PHASE_IDLE;
+        exercise_reset_envelope(signal);
+    }
+
+    exercise_track_envelope(signal);
+
+    env_min = (signed short) (sExercise.env_min >> EXERCISE_ENVELOPE_FRAC);
+    span = (signed short) ((sExercise.env_max - sExercise.env_min) >> EXERCISE_ENVELOPE_FRAC);
+    down_threshold = env_min + span - (span >> 2);
+    up_threshold = env_min + (span >> 2);
+
+    // Too little movement for a repetition - also keeps noise out of the down phase
+    if (span < profile->min_span)
+        down_threshold = 0x7FFF;
+#else
+    sExercise.projected = projected;
+#endif
+
+#if (DTW_MATCHER == 1)
+    dtw_add_sample(signal);
+#endif
+
+    // Stay in down phase as long as signal is above threshold, rise timing starts when leaving it
+    if (signal >= down_threshold)
+    {
+        sExercise.phase = EXERCISE_PHASE_DOWN;
+        sExercise.samples = 0;
+        return (0);
+    }
+
+    // No repetition without preceding down phase
+    if (sExercise.phase == EXERCISE_PHASE_IDLE)
+        return (0);
+
+    sExercise.phase = EXERCISE_PHASE_RISE;
+    sExercise.samples++;
+
+    if (sExercise.samples > profile->max_rise_samples)
+    {
+        // Movement too slow - abandon repetition
+        sExercise.phase = EXERCISE_PHASE_IDLE;
+    }
+    else if (signal <= up_threshold)
+    {
+        sExercise.phase = EXERCISE_PHASE_IDLE;
+
+        // Movements faster than min_rise_samples are jerks, not repetitions
+        if (sExercise.samples < profile->min_rise_samples)
+            return (0);
+
+#if (DTW_MATCHER == 1)
+        // Reject candidates with a shape unlike any template
+        if (profile->templates != 0)
+            return (dtw_match(profile->templates, profile->num_templates, profile->dtw_threshold));
+#endif
+        return (1);
+    }
+
+    return (0);
+}
@@ -0,0 +1,117 @@
+// *************************************************************************************************
+//      Copyright (C) 2009 Texas Instruments Incorporated - http://www.ti.com/
+//
+//        Redistribution and use in source and binary forms, with or without
+//        modification, are permitted provided that the following conditions
+//        are met:
+//
+//          Redistributions of source code must retain the above copyright
+//          notice, this list of conditions and the following disclaimer.
+//
+//          Redistributions in binary form must reproduce the above copyright
+//          notice, this list of conditions and the following disclaimer in the
+//          documentation and/or other materials provided with the
+//          distribution.
+//
+//          Neither the name of Texas Instruments Incorporated nor the names of
+//          its contributors may be used to endorse or promote products derived
+//          from this software without specific prior written permission.
+//
+//        THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+//        "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+//        LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+//        A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+//        OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+//        SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+//        LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+//        DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+//        THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//        (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+//        OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// *************************************************************************************************
+
+#ifndef EXERCISE_H_
+#define EXERCISE_H_
+
+// *************************************************************************************************
+// Include section
+#include <project.h>
+#include "acceleration.h"
+#include "dtw.h"
+#include "gravity.h"
+
+// *************************************************************************************************
+// Defines section
+
+// Detector phases
+#define EXERCISE_PHASE_IDLE             (0u)
+#define EXERCISE_PHASE_DOWN             (1u)
+#define EXERCISE_PHASE_RISE             (2u)
+
+// Conversion from msec to detector samples, multiplied in 32 bits as int is 16 bits on the MSP430
+#define CONV_MS_TO_SAMPLES(msec)        (((unsigned long) (msec) * ACCEL_DETECT_RATE_HZ) / 1000)
+
+// 1 = Place thresholds inside the running min/max envelope instead of using absolute values
+#define EXERCISE_ADAPTIVE               (1)
+
+// Envelope decay towards the signal (2^9 sensor samples = 4s, independent of decimation)
+#define EXERCISE_ENVELOPE_SHIFT         (9u - ACCEL_DECIMATION_SHIFT)
+
+// Fractional bits of the envelope, enough for a nonzero decay step down to 1/8 signal unit
+#define EXERCISE_ENVELOPE_FRAC          (12u)
+
+// *************************************************************************************************
+// Global Variable section
+
+// Exercise profile, stored in flash
+//
+// The detector combines the filtered X/Y acceleration (10 * mgrav) into one tilt signal
+// (weight_x * x + weight_y * y). A repetition starts when the signal reaches down_threshold and
+// is counted when it returns to up_threshold within min_rise_samples .. max_rise_samples.
+// With DTW_MATCHER enabled the last second of the signal must also match one of the templates.
+// With GRAVITY_PROJECTION enabled the signal is the motion along the learned axis as soon as
+// that axis is locked, compared against the proj_*_threshold values.
+// With EXERCISE_ADAPTIVE enabled both thresholds are replaced by 3/4 and 1/4 of the span between
+// the decaying running min and max of the signal. No repetition is detected while the span is
+// below min_span.
+struct exercise_profile
+{
+    unsigned char symbol;                  // Character shown in LCD_SEG_L1_3
+    signed char weight_x;                  // X-axis weight of tilt signal
+    signed char weight_y;                  // Y-axis weight of tilt signal
+    signed short down_threshold;           // Tilt signal >= down_threshold: down phase
+    signed short up_threshold;             // Tilt signal <= up_threshold: repetition complete
+    unsigned short min_rise_samples;       // Faster movements are ignored
+    unsigned short max_rise_samples;       // Slower movements are abandoned
+    const struct dtw_template *templates;  // Repetition templates, 0 = no DTW verification
+    unsigned char num_templates;           // Number of templates
+    unsigned short dtw_threshold;          // Maximum DTW distance of a repetition
+    signed short proj_down_threshold;      // Projection >= proj_down_threshold: down phase
+    signed short proj_up_threshold;        // Projection <= proj_up_threshold: repetition complete
+    signed short min_span;                 // Smallest envelope span of a repetition
+};
+
+struct exercise
+{
+    const struct exercise_profile *profile; // Selected profile
+    unsigned char phase;                   // EXERCISE_PHASE_IDLE, _DOWN, _RISE
+    unsigned short samples;                // Samples since leaving the down phase
+    signed short signal;                   // Last tilt signal
+    signed long env_max;                   // Running max of signal (Q12)
+    signed long env_min;                   // Running min of signal (Q12)
+    unsigned char projected;               // 1 = signal is the gravity projection
+};
+extern struct exercise sExercise;
+
+// Available profiles
+extern const struct exercise_profile exercise_situp;
+extern const struct exercise_profile exercise_pushup;
+extern const struct exercise_profile exercise_squat;
+
+// *************************************************************************************************
+// Extern section
+extern void reset_exercise(void);
+extern void select_exercise(const struct exercise_profile *profile);
+extern unsigned char detect_exercise(unsigned short x, unsigned short y);
+
+#endif                          /*EXERCISE_H_ */
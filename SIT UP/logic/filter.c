@@ -0,0 +1,196 @@
+// *************************************************************************************************
+//      Copyright (C) 2009 Texas Instruments Incorporated - http://www.ti.com/
+//
+//        Redistribution and use in source and binary forms, with or without
+//        modification, are permitted provided that the following conditions
+//        are met:
+//
+//          Redistributions of source code must retain the above copyright
+//          notice, this list of conditions and the following disclaimer.
+//
+//          Redistributions in binary form must reproduce the above copyright
+//          notice, this list of conditions and the following disclaimer in the
+//          documentation and/or other materials provided with the
+//          distribution.
+//
+//          Neither the name of Texas Instruments Incorporated nor the names of
+//          its contributors may be used to endorse or promote products derived
+//          from this software without specific prior written permission.
+//
+//        THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+//        "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+//        LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+//        A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+//        OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+//        SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+//        LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+//        DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+//        THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//        (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+//        OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// *************************************************************************************************
+// Sample filters for the acceleration pipeline.
+// *************************************************************************************************
+// Include section
+
+// system
+#include "project.h"
+
+// logic
+#include "filter.h"
+
+// *************************************************************************************************
+// Defines section
+
+// Compare-exchange step of a sorting network, a <= b afterwards
+#define FILTER_SORT(a, b)               { if ((a) > (b)) { t = (a); (a) = (b); (b) = t; } }
+
+// *************************************************************************************************
+// @fn          reset_median
+// @brief       Mark median filter as empty. The next sample fills all taps.
+// @param       struct median * filter     Filter state
+// @return      none
+// *************************************************************************************************
+void reset_median(struct median *filter)
+{
+    filter->head = FILTER_MEDIAN_EMPTY;
+}
+
+// *************************************************************************************************
+// @fn          median_filter
+// @brief       Add sample and return the median of the last FILTER_MEDIAN_TAPS samples. Fixed
+//              cost: 3 (3 taps) or 7 (5 taps) compare-exchange steps, no sorting loop.
+// @param       struct median * filter     Filter state
+//              signed short sample        New sample
+// @return      signed short               Median
+// *************************************************************************************************
+signed short median_filter(struct median *filter, signed short sample)
+{
+    signed short v0, v1, v2;
+#if (FILTER_MEDIAN_TAPS == 5)
+    signed short v3, v4;
+#endif
+    signed short t;
+    unsigned char i;
+
+    // First sample after reset fills all taps
+    if (filter->head == FILTER_MEDIAN_EMPTY)
+    {
+        for (i = 0; i < FILTER_MEDIAN_TAPS; i++)
+            filter->tap[i] = sample;
+        filter->head = 0;
+    }
+
+    filter->tap[filter->head] = sample;
+    if (++filter->head >= FILTER_MEDIAN_TAPS)
+        filter->head = 0;
+
+#if (FILTER_MEDIAN_TAPS == 1)
+    return (sample);
+#elif (FILTER_MEDIAN_TAPS == 3)
+    v0 = filter->tap[0];
+    v1 = filter->tap[1];
+    v2 = filter->tap[2];
+
+    FILTER_SORT(v0, v1);
+    FILTER_SORT(v1, v2);
+    FILTER_SORT(v0, v1);
+
+    return (v1);
+#elif (FILTER_MEDIAN_TAPS == 5)
+    v0 = filter->tap[0];
+    v1 = filter->tap[1];
+    v2 = filter->tap[2];
+    v3 = filter->tap[3];
+    v4 = filter->tap[4];
+
+    // Median selection network, v2 holds the median afterwards
+    FILTER_SORT(v0, v1);
+    FILTER_SORT(v3, v4);
+    FILTER_SORT(v0, v3);
+    FILTER_SORT(v1, v4);
+    FILTER_SORT(v1, v2);
+    FILTER_SORT(v2, v3);
+    FILTER_SORT(v1, v2);
+
+    return (v2);
+#else
+    #error "Median filter length not supported"
+#endif
+}
+
+// *************************************************************************************************
+// @fn          reset_boxcar
+// @brief       Start a new averaging block.
+// @param       struct boxcar * filter     Filter state
+// @return      none
+// *************************************************************************************************
+void reset_boxcar(struct boxcar *filter)
+{
+    filter->sum = 0;
+    filter->count = 0;
+}
+
+// *************************************************************************************************
+// @fn          boxcar_filter
+// @brief       Average blocks of 2^shift samples (decimating moving average).
+// @param       struct boxcar * filter     Filter state
+//              signed short sample        New sample (10 * mgrav)
+//              unsigned char shift        Block length 2^shift
+// @return      unsigned char              1 = Block complete, average in filter->out
+// *************************************************************************************************
+unsigned char boxcar_filter(struct boxcar *filter, signed short sample, unsigned char shift)
+{
+    filter->sum += sample;
+
+    if (++filter->count < (1u << shift))
+        return (0);
+
+    filter->out = filter->sum >> shift;
+    filter->sum = 0;
+    filter->count = 0;
+
+    return (1);
+}
+
+// *************************************************************************************************
+// @fn          reset_kalman
+// @brief       Mark Kalman filter as empty. The next sample initializes the position.
+// @param       struct kalman * filter     Filter state
+// @return      none
+// *************************************************************************************************
+void reset_kalman(struct kalman *filter)
+{
+    filter->empty = 1;
+}
+
+// *************************************************************************************************
+// @fn          kalman_filter
+// @brief       Constant velocity Kalman filter with gains fixed at compile time: predict with the
+//              rate, then correct position and rate by the innovation.
+// @param       struct kalman * filter     Filter state
+//              signed short sample        New sample (10 * mgrav)
+// @return      signed short               Filtered sample
+// *************************************************************************************************
+signed short kalman_filter(struct kalman *filter, signed short sample)
+{
+    signed long innovation;
+
+    if (filter->empty)
+    {
+        filter->pos = (signed long) sample << FILTER_KALMAN_SHIFT;
+        filter->rate = 0;
+        filter->empty = 0;
+    }
+
+    // Predict
+    filter->pos += filter->rate;
+
+    // Correct
+    innovation = ((signed long) sample << FILTER_KALMAN_SHIFT) - filter->pos;
+    filter->pos += (FILTER_KALMAN_GAIN_POS * innovation) >> FILTER_KALMAN_SHIFT;
+    filter->rate += (FILTER_KALMAN_GAIN_RATE * innovation) >> FILTER_KALMAN_SHIFT;
+
+    // Round to 10 * mgrav
+    return ((signed short) ((filter->pos + (1L << (FILTER_KALMAN_SHIFT - 1))) >> FILTER_KALMAN_SHIFT));
+}
@@ -0,0 +1,205 @@
+// *************************************************************************************************
+//      Copyright (C) 2009 Texas Instruments Incorporated - http://www.ti.com/
+//
+//        Redistribution and use in source and binary forms, with or without
+//        modification, are permitted provided that the following conditions
+//        are met:
+//
+//          Redistributions of source code must retain the above copyright
+//          notice, this list of conditions and the following disclaimer.
+//
+//          Redistributions in binary form must reproduce the above copyright
+//          notice, this list of conditions and the following disclaimer in the
+//          documentation and/or other materials provided with the
+//          distribution.
+//
+//          Neither the name of Texas Instruments Incorporated nor the names of
+//          its contributors may be used to endorse or promote products derived
+//          from this software without specific prior written permission.
+//
+//        THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+//        "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+//        LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+//        A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+//        OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+//        SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+//        LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+//        DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+//        THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//        (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+//        OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// *************************************************************************************************
+// Gravity tracking and projection onto the dominant motion axis.
+// *************************************************************************************************
+// Include section
+
+// system
+#include "project.h"
+
+// logic
+#include "gravity.h"
+
+// *************************************************************************************************
+// Prototypes section
+unsigned short gravity_sqrt(unsigned long value);
+void gravity_lock_axis(void);
+
+// *************************************************************************************************
+// Global Variable section
+struct gravity sGravity;
+
+// *************************************************************************************************
+// @fn          reset_gravity
+// @brief       Forget gravity estimate and motion axis. Next samples start learning again.
+// @param       none
+// @return      none
+// *************************************************************************************************
+void reset_gravity(void)
+{
+    unsigned char i;
+
+    for (i = 0; i < 3; i++)
+    {
+        sGravity.smooth[i] = 0;
+        sGravity.track[i] = 0;
+        sGravity.axis[i] = 0;
+    }
+    sGravity.learned = 0;
+    sGravity.state = GRAVITY_START;
+    sGravity.projection = 0;
+}
+
+// *************************************************************************************************
+// @fn          gravity_sqrt
+// @brief       Integer square root, bit by bit.
+// @param       unsigned long value
+// @return      unsigned short             floor(sqrt(value))
+// *************************************************************************************************
+unsigned short gravity_sqrt(unsigned long value)
+{
+    unsigned long result = 0;
+    unsigned long bit = 1uL << 30;
+
+    while (bit > value)
+        bit >>= 2;
+
+    while (bit != 0)
+    {
+        if (value >= result + bit)
+        {
+            value -= result + bit;
+            result = (result >> 1) + bit;
+        }
+        else
+        {
+            result >>= 1;
+        }
+        bit >>= 2;
+    }
+
+    return ((unsigned short) result);
+}
+
+// *************************************************************************************************
+// @fn          gravity_lock_axis
+// @brief       Normalize learned motion axis to a Q7 unit vector. Runs once per learning phase.
+// @param       none
+// @return      none
+// *************************************************************************************************
+void gravity_lock_axis(void)
+{
+    unsigned long length2 = 0;
+    unsigned short length;
+    unsigned char i;
+
+    for (i = 0; i < 3; i++)
+        length2 += (signed long) sGravity.axis[i] * sGravity.axis[i];
+
+    length = gravity_sqrt(length2);
+
+    // No motion direction - keep learning
+    if (length == 0)
+    {
+        sGravity.learned = 0;
+        return;
+    }
+
+    for (i = 0; i < 3; i++)
+        sGravity.axis[i] = ((signed long) sGravity.axis[i] << GRAVITY_UNIT_SHIFT) / length;
+
+    sGravity.state = GRAVITY_LOCKED;
+}
+
+// *************************************************************************************************
+// @fn          gravity_add_sample
+// @brief       Track gravity with a slow low-pass and split off the motion component. While
+//              learning, average the motion direction (sign aligned). Once locked, project the
+//              motion onto the axis. The first motion leaves the start (down) position, so that
+//              side of the axis is positive like the fixed X/Y tilt signal.
+// @param       signed short x, y, z       Acceleration (10 * mgrav)
+// @return      none
+// *************************************************************************************************
+void gravity_add_sample(signed short x, signed short y, signed short z)
+{
+    signed short in[3];
+    signed short motion[3];
+    signed long dot = 0;
+    signed short energy = 0;
+    unsigned char i;
+
+    in[0] = x;
+    in[1] = y;
+    in[2] = z;
+
+    // First sample after reset initializes the filters
+    if (sGravity.state == GRAVITY_START)
+    {
+        for (i = 0; i < 3; i++)
+        {
+            sGravity.smooth[i] = in[i] << 4;
+            sGravity.track[i] = (signed long) in[i] << 8;
+        }
+        sGravity.state = GRAVITY_LEARNING;
+        return;
+    }
+
+    for (i = 0; i < 3; i++)
+    {
+        sGravity.smooth[i] += ((in[i] << 4) - sGravity.smooth[i]) >> GRAVITY_SMOOTH_SHIFT;
+        sGravity.track[i] += (((signed long) sGravity.smooth[i] << 4) - sGravity.track[i])
+                             >> GRAVITY_TRACK_SHIFT;
+
+        motion[i] = (sGravity.smooth[i] >> 4) - (signed short) (sGravity.track[i] >> 8);
+        dot += (signed long) motion[i] * sGravity.axis[i];
+        energy += (motion[i] < 0) ? -motion[i] : motion[i];
+    }
+
+    if (sGravity.state == GRAVITY_LOCKED)
+    {
+        sGravity.projection = dot >> GRAVITY_UNIT_SHIFT;
+        return;
+    }
+
+    // Learn only from samples with clear motion
+    if (energy < GRAVITY_MOTION_MIN)
+        return;
+
+    for (i = 0; i < 3; i++)
+    {
+        if (sGravity.learned == 0)
+        {
+            // Seed axis pointing back to the start position
+            sGravity.axis[i] = -(motion[i] << 4);
+        }
+        else
+        {
+            // Flip samples into the half space of the current axis
+            if (dot < 0)
+                motion[i] = -motion[i];
+            sGravity.axis[i] += ((motion[i] << 4) - sGravity.axis[i]) >> GRAVITY_AXIS_SHIFT;
+        }
+    }
+
+    if (++sGravity.learned >= GRAVITY_LEARN_SAMPLES)
+        gravity_lock_axis();
+}
@@ -0,0 +1,85 @@
+// *************************************************************************************************
+//      Copyright (C) 2009 Texas Instruments Incorporated - http://www.ti.com/
+//
+//        Redistribution and use in source and binary forms, with or without
+//        modification, are permitted provided that the following conditions
+//        are met:
+//
+//          Redistributions of source code must retain the above copyright
+//          notice, this list of conditions and the following disclaimer.
+//
+//          Redistributions in binary form must reproduce the above copyright
+//          notice, this list of conditions and the following disclaimer in the
+//          documentation and/or other materials provided with the
+//          distribution.
+//
+//          Neither the name of Texas Instruments Incorporated nor the names of
+//          its contributors may be used to endorse or promote products derived
+//          from this software without specific prior written permission.
+//
+//        THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+//        "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+//        LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+//        A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+//        OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+//        SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+//        LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+//        DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+//        THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//        (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+//        OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// *************************************************************************************************
+
+#ifndef GRAVITY_H_
+#define GRAVITY_H_
+
+// *************************************************************************************************
+// Include section
+#include <project.h>
+#include "acceleration.h"
+
+// *************************************************************************************************
+// Defines section
+
+// 1 = Detect on the projection onto the learned motion axis instead of fixed X/Y weights
+#define GRAVITY_PROJECTION              (1)
+
+// Low-pass shifts: sample smoothing (approx. 30ms) and gravity (approx. 8s)
+#define GRAVITY_SMOOTH_SHIFT            (2u - ACCEL_DECIMATION_SHIFT)
+#define GRAVITY_TRACK_SHIFT             (10u - ACCEL_DECIMATION_SHIFT)
+
+// Motion axis averaging shift while learning
+#define GRAVITY_AXIS_SHIFT              (5u - ACCEL_DECIMATION_SHIFT)
+
+// Minimum deviation from gravity (sum of axes, 10 * mgrav) to learn from a sample
+#define GRAVITY_MOTION_MIN              (15)
+
+// Samples with motion needed to lock the axis (3s, about the first 2-3 repetitions)
+#define GRAVITY_LEARN_SAMPLES           (3u * ACCEL_DETECT_RATE_HZ)
+
+// Unit axis fixed-point shift (Q7)
+#define GRAVITY_UNIT_SHIFT              (7u)
+
+#define GRAVITY_START                   (0u)
+#define GRAVITY_LEARNING                (1u)
+#define GRAVITY_LOCKED                  (2u)
+
+// *************************************************************************************************
+// Global Variable section
+struct gravity
+{
+    signed short smooth[3];                // Smoothed acceleration (Q4, 10 * mgrav)
+    signed long track[3];                  // Gravity estimate (Q8, 10 * mgrav)
+    signed short axis[3];                  // Motion axis, learning: Q4 average, locked: Q7 unit
+    unsigned short learned;                // Samples with motion seen while learning
+    unsigned char state;                   // GRAVITY_START, GRAVITY_LEARNING, GRAVITY_LOCKED
+    signed short projection;               // Motion along axis (10 * mgrav)
+};
+extern struct gravity sGravity;
+
+// *************************************************************************************************
+// Extern section
+extern void reset_gravity(void);
+extern void gravity_add_sample(signed short x, signed short y, signed short z);
+
+#endif                          /*GRAVITY_H_ */
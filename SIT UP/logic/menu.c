@@ -43,6 +43,8 @@
 #include "menu.h"
 #include "stopwatch.h"
 #include "acceleration.h"
+#include "cadence.h"
+#include "diagnostics.h"
 
 #include <string.h>
 
@@ -68,20 +70,49 @@ unsigned char update_acceleration(void)
     return (display.flag.update_acceleration);
 }
 
+unsigned char update_cadence(void)
+{
+    return (display.flag.update_cadence);
+}
+
+unsigned char update_diagnostics(void)
+{
+    return (display.flag.update_diagnostics);
+}
+
 // *************************************************************************************************
 // User navigation ( [____] = default menu item after reset )
 //
-//      LINE1: Acceleration
+//      LINE1: [Sit-up] -> Push-up -> Squat
 //
-//      LINE2: Stopwatch
+//      LINE2: [Stopwatch] -> Cadence
 // *************************************************************************************************
 
-// Line1 - Acceleration
-const struct menu menu_L1_Acceleration = {
+// Line1 - Sit-up
+const struct menu menu_L1_Situp = {
     FUNCTION(sx_acceleration),        // direct function
     FUNCTION(mx_acceleration),                  // sub menu function
-    FUNCTION(display_acceleration),   // display function
+    FUNCTION(display_situp),          // display function
+    FUNCTION(update_acceleration),    // new display data
+    &menu_L1_Pushup,
+};
+
+// Line1 - Push-up
+const struct menu menu_L1_Pushup = {
+    FUNCTION(sx_acceleration),        // direct function
+    FUNCTION(mx_acceleration),        // sub menu function
+    FUNCTION(display_pushup),         // display function
+    FUNCTION(update_acceleration),    // new display data
+    &menu_L1_Squat,
+};
+
+// Line1 - Squat
+const struct menu menu_L1_Squat = {
+    FUNCTION(sx_acceleration),        // direct function
+    FUNCTION(mx_acceleration),        // sub menu function
+    FUNCTION(display_squat),          // display function
     FUNCTION(update_acceleration),    // new display data
+    &menu_L1_Situp,
 };
 
 // Line2 - Stopwatch
@@ -90,4 +121,23 @@ const struct menu menu_L2_Stopwatch = {
     FUNCTION(mx_stopwatch),           // sub menu function
     FUNCTION(display_stopwatch),      // display function
     FUNCTION(update_stopwatch),       // new display data
+    &menu_L2_Cadence,
+};
+
+// Line2 - Cadence
+const struct menu menu_L2_Cadence = {
+    FUNCTION(sx_cadence),             // direct function
+    FUNCTION(mx_cadence),             // sub menu function
+    FUNCTION(display_cadence),        // display function
+    FUNCTION(update_cadence),         // new display data
+    &menu_L2_Diagnostics,
+};
+
+// Line2 - Diagnostics
+const struct menu menu_L2_Diagnostics = {
+    FUNCTION(sx_diagnostics),         // direct function
+    FUNCTION(mx_diagnostics),         // sub menu function
+    FUNCTION(display_diagnostics),    // display function
+    FUNCTION(update_diagnostics),     // new display data
+    &menu_L2_Stopwatch,
 };
@@ -43,13 +43,19 @@ struct menu
     void (*display_function)(unsigned char line, unsigned char mode);
     // Display update trigger
     unsigned char (*display_update)(void);
+    // Pointer to next menu item
+    const struct menu *next;
 };
 
 // Line1 navigation
-extern const struct menu menu_L1_Acceleration;
+extern const struct menu menu_L1_Situp;
+extern const struct menu menu_L1_Pushup;
+extern const struct menu menu_L1_Squat;
 
 // Line2 navigation
 extern const struct menu menu_L2_Stopwatch;
+extern const struct menu menu_L2_Cadence;
+extern const struct menu menu_L2_Diagnostics;
 
 // Pointers to current menu item
 extern const struct menu *ptrMenu_L1;
@@ -46,6 +46,7 @@
 
 // logic
 #include "menu.h"
+#include "acceleration.h"
 
 // *************************************************************************************************
 // Prototypes section
@@ -57,6 +58,7 @@ void update_stopwatch_timer(void);
 void mx_stopwatch(unsigned char line);
 void sx_stopwatch(unsigned char line);
 void display_stopwatch(unsigned char line, unsigned char update);
+void display_stopwatch_stopped(void);
 
 // *************************************************************************************************
 // Global Variable section
@@ -108,8 +110,6 @@ void update_stopwatch_timer(void)
 /****************************************************************************************************/
 void countdownTimer(void)
 {
-    static unsigned char delay = 0;
-
     // Add 1/100 sec
 	sStopwatch.time[7]--;
 
@@ -121,11 +121,11 @@ void countdownTimer(void)
     // swt.drawFlag = 5: hours L, minutes H/L, second H/L
     // swt.drawFlag = 6: hours H/L, minutes H/L, second H/L
     // swt.drawFlag = 7: 1/10 sec, 1/100 sec
-    // swt.drawFlag = 8: 1/100 sec (every 17/100 sec to reduce display draw activity)
-    if (delay++ > 17)
+    // swt.drawFlag = 8: 1/100 sec (display_update limits redraws to DISPLAY_LINE2_MIN_TICKS)
+    // Flags not drawn yet are merged, lower values 1..4 include more digits than 7 and 8
+    if (sStopwatch.drawFlag == 0)
     {
         sStopwatch.drawFlag = 8;
-        delay = 0;
     }
 
     // Add 1/10 sec
@@ -140,14 +140,16 @@ void countdownTimer(void)
         sStopwatch.swtIs10Hz = 1;
 
         // Update draw flag
-        sStopwatch.drawFlag = 7;
+        if (sStopwatch.drawFlag == 8)
+            sStopwatch.drawFlag = 7;
     }
 
     // Second overflow?
     if (sStopwatch.time[6] == 0x2f)
     {
         // Reset draw flag
-        sStopwatch.drawFlag = 1;
+        if (sStopwatch.drawFlag >= 7)
+            sStopwatch.drawFlag = 1;
 
         // 1Hz trigger
         sStopwatch.swtIs1Hz = 1;
@@ -176,9 +178,11 @@ void countdownTimer(void)
         	start_buzzer(5, CONV_MS_TO_TICKS(200), BUZZER_OFF_TICKS);
         	stop_stopwatch();
 
-            // Clear counter
+            // Clear counter, display_stopwatch_stopped draws it
             memcpy(sStopwatch.time, "00000000", sizeof(sStopwatch.time));
-        	display_stopwatch(2, DISPLAY_LINE_UPDATE_FULL);
+
+        	// Flash final count until next button press
+        	display_post(display_final_count);
         }
         else
         {
@@ -188,7 +192,8 @@ void countdownTimer(void)
 
               if (sStopwatch.time[5] == 0x2f)
               {
-                  sStopwatch.drawFlag++;                 // 2
+                  if (sStopwatch.drawFlag < 2)
+                      sStopwatch.drawFlag = 2;           // 2
                   sStopwatch.time[5] = '9';
                   sStopwatch.time[4]--;                  // second  H (0 - 5)
               }
@@ -210,6 +215,9 @@ void reset_stopwatch(void)
     // Clear counter
     memcpy(sStopwatch.time, "00006000", sizeof(sStopwatch.time));
 
+    // Nothing to draw
+    sStopwatch.drawFlag = 0;
+
     // Clear trigger
     sStopwatch.swtIs10Hz = 0;   // 1/10Hz trigger
     sStopwatch.swtIs1Hz = 0;    // 1Hz trigger
@@ -254,6 +262,12 @@ void start_stopwatch(void)
 
     // Set stopwatch icon
     display_symbol(LCD_ICON_STOPWATCH, SEG_ON);
+
+    // Flash icon while the countdown runs, LCD_B switches the frames
+    display_animation(LCD_ANIMATION_FAST);
+    display_frame(LCD_FRAME_B);
+    display_symbol(LCD_ICON_STOPWATCH, SEG_OFF);
+    display_frame(LCD_FRAME_BOTH);
 }
 
 // *************************************************************************************************
@@ -271,11 +285,25 @@ void stop_stopwatch(void)
     // Clear stopwatch run flag
     sStopwatch.state = STOPWATCH_STOP;
 
+    // Called from button and countdown ISRs, draw in main loop
+    display_post(display_stopwatch_stopped);
+}
+
+// *************************************************************************************************
+// @fn          display_stopwatch_stopped
+// @brief       Display command posted by stop_stopwatch. Clears icon and redraws stopwatch.
+// @param       none
+// @return      none
+// *************************************************************************************************
+void display_stopwatch_stopped(void)
+{
     // Clear stopwatch icon
+    display_animation(LCD_ANIMATION_OFF);
     display_symbol(LCD_ICON_STOPWATCH, SEG_OFF);
 
-    // Call draw routine immediately
-    display_stopwatch(LINE2, DISPLAY_LINE_UPDATE_FULL);
+    // Call draw routine, if stopwatch is visible
+    if (ptrMenu_L2 == &menu_L2_Stopwatch)
+        display_stopwatch(LINE2, DISPLAY_LINE_UPDATE_FULL);
 }
 
 // *************************************************************************************************
@@ -332,30 +360,34 @@ void sx_stopwatch(unsigned char line)
 // *************************************************************************************************
 void display_stopwatch(unsigned char line, unsigned char update)
 {
+    unsigned char draw;
+    unsigned short int_state;
+
     // Partial line update only
     if (update == DISPLAY_LINE_UPDATE_PARTIAL)
     {
-        if (display.flag.update_stopwatch)
+        // Take draw flag, countdown ISR merges new changes into a cleared flag
+        int_state = __get_interrupt_state();
+        __disable_interrupt();
+        draw = sStopwatch.drawFlag;
+        sStopwatch.drawFlag = 0;
+        __set_interrupt_state(int_state);
+
+        // Draw digits changed since last redraw
+        switch (draw)
         {
-        	// Check draw flag to minimize workload
-        	if (sStopwatch.drawFlag != 0)
-        	{
-        		switch (sStopwatch.drawFlag)
-        	    {
-        	    	case 4:
-        	        	display_char(LCD_SEG_L2_5, sStopwatch.time[2], SEG_ON);
-        	        case 3:
-        	        	display_char(LCD_SEG_L2_4, sStopwatch.time[3], SEG_ON);
-        	        case 2:
-        	        	display_char(LCD_SEG_L2_3, sStopwatch.time[4], SEG_ON);
-        	        case 1:
-        	            display_char(LCD_SEG_L2_2, sStopwatch.time[5], SEG_ON);
-        	        case 7:
-        	            display_char(LCD_SEG_L2_1, sStopwatch.time[6], SEG_ON);
-        	        case 8:
-        	            display_char(LCD_SEG_L2_0, sStopwatch.time[7], SEG_ON);
-        	    }
-        	}
+            case 4:
+                display_char(LCD_SEG_L2_5, sStopwatch.time[2], SEG_ON);
+            case 3:
+                display_char(LCD_SEG_L2_4, sStopwatch.time[3], SEG_ON);
+            case 2:
+                display_char(LCD_SEG_L2_3, sStopwatch.time[4], SEG_ON);
+            case 1:
+                display_char(LCD_SEG_L2_2, sStopwatch.time[5], SEG_ON);
+            case 7:
+                display_char(LCD_SEG_L2_1, sStopwatch.time[6], SEG_ON);
+            case 8:
+                display_char(LCD_SEG_L2_0, sStopwatch.time[7], SEG_ON);
         }
     }
     // Redraw whole line
@@ -62,6 +62,9 @@
 #include "menu.h"
 #include "stopwatch.h"
 #include "acceleration.h"
+#include "exercise.h"
+#include "cadence.h"
+#include "diagnostics.h"
 
 // *************************************************************************************************
 // Prototypes section
@@ -70,7 +73,9 @@ void init_global_variables(void);
 void wakeup_event(void);
 void process_requests(void);
 void display_update(void);
+unsigned char display_rate_due(unsigned char line, unsigned char new_data, unsigned long now);
 void idle_loop(void);
+unsigned char tick_needed(void);
 void configure_ports(void);
 
 // *************************************************************************************************
@@ -124,9 +129,25 @@ int main(void)
         if (request.all_flags)
             process_requests();
 
+        // Run display commands posted by interrupts
+        display_drain();
+
         // Before going to LPM3, update display
         if (display.all_flags)
             display_update();
+
+        // Full LCD frame rate only while a session is running, the sensor stays in
+        // ACCEL_MODE_ON after its timeout
+        if (is_acceleration_measurement() || (sStopwatch.state == STOPWATCH_RUN))
+            lcd_power_mode(LCD_POWER_ACTIVE);
+        else
+            lcd_power_mode(LCD_POWER_IDLE);
+
+        // Write changed segments to LCD memory
+        lcd_flush();
+
+        // Sleep until next event or deadline, 1/1sec tick only while needed
+        Timer0_Tick_Enable(tick_needed());
     }
 }
 
@@ -238,7 +259,7 @@ void init_application(void)
 void init_global_variables(void)
 {
     // set menu pointers to default menu items
-            ptrMenu_L1 = &menu_L1_Acceleration;
+            ptrMenu_L1 = &menu_L1_Situp;
 
             ptrMenu_L2 = &menu_L2_Stopwatch;
 
@@ -268,6 +289,15 @@ void init_global_variables(void)
 
     // Reset acceleration measurement
     reset_acceleration();
+
+    // Reset exercise detector
+    reset_exercise();
+
+    // Reset cadence estimate
+    reset_cadence();
+
+    // Start with first diagnostics page
+    reset_diagnostics();
 }
 
 // *************************************************************************************************
@@ -281,6 +311,14 @@ void wakeup_event(void)
     // Enable idle timeout
     sys.flag.idle_timeout_enabled = 1;
 
+    // Any button press restarts suspended acceleration measurement
+    if (button.all_flags && (sAccel.mode == ACCEL_MODE_SUSPENDED))
+        resume_acceleration();
+
+    // Any button press ends the final count animation
+    if (button.all_flags && (sStopwatch.state == STOPWATCH_STOP))
+        display_animation(LCD_ANIMATION_OFF);
+
     // If buttons are locked, only display "buttons are locked" message
     if (button.all_flags && sys.flag.lock_buttons)
     {
@@ -319,9 +357,47 @@ void wakeup_event(void)
     // Process single button press event (after button was released)
     else if (button.all_flags)
     {
+        // STAR button event ---------------------------------------------------------------------
+        // (Short) Advance to next menu item
+        if (button.flag.star)
+        {
+            // Clean up display before activating next menu item
+            fptr_lcd_function_line1(LINE1, DISPLAY_LINE_CLEAR);
+
+            // Go to next menu entry
+            ptrMenu_L1 = ptrMenu_L1->next;
+
+            // Assign new display function
+            fptr_lcd_function_line1 = ptrMenu_L1->display_function;
+
+            // Set Line1 display update flag
+            display.flag.line1_full_update = 1;
+
+            // Clear button flag
+            button.flag.star = 0;
+        }
+        // NUM button event ----------------------------------------------------------------------
+        // (Short) Advance to next menu item
+        else if (button.flag.num)
+        {
+            // Clean up display before activating next menu item
+            fptr_lcd_function_line2(LINE2, DISPLAY_LINE_CLEAR);
+
+            // Go to next menu entry
+            ptrMenu_L2 = ptrMenu_L2->next;
+
+            // Assign new display function
+            fptr_lcd_function_line2 = ptrMenu_L2->display_function;
+
+            // Set Line2 display update flag
+            display.flag.line2_full_update = 1;
+
+            // Clear button flag
+            button.flag.num = 0;
+        }
         // DOWN button event ---------------------------------------------------------------------
         // Activate user function for Line2 menu item
-        if (button.flag.down)
+        else if (button.flag.down)
         {
             // Call direct function
             ptrMenu_L2->sx_function(LINE2);
@@ -380,6 +456,7 @@ void display_update(void)
 {
     unsigned char line;
     unsigned char string[8];
+    unsigned long now = Timer0_Timestamp();
 
     // ---------------------------------------------------------------------
     // Call Line1 display function
@@ -387,7 +464,9 @@ void display_update(void)
     {
         clear_line(LINE1);
         fptr_lcd_function_line1(LINE1, DISPLAY_LINE_UPDATE_FULL);
-    } else if (ptrMenu_L1->display_update())
+        sDisplayRate.pending &= ~BIT0;
+        sDisplayRate.last[0] = now;
+    } else if (display_rate_due(LINE1, ptrMenu_L1->display_update(), now))
     {
         // Update line1 only when new data is available
         fptr_lcd_function_line1(LINE1, DISPLAY_LINE_UPDATE_PARTIAL);
@@ -419,7 +498,9 @@ void display_update(void)
     {
         clear_line(LINE2);
         fptr_lcd_function_line2(LINE2, DISPLAY_LINE_UPDATE_FULL);
-    } else if (ptrMenu_L2->display_update() && !message.all_flags)
+        sDisplayRate.pending &= ~BIT1;
+        sDisplayRate.last[1] = now;
+    } else if (!message.all_flags && display_rate_due(LINE2, ptrMenu_L2->display_update(), now))
     {
         // Update line2 only when new data is available
         fptr_lcd_function_line2(LINE2, DISPLAY_LINE_UPDATE_PARTIAL);
@@ -429,6 +510,49 @@ void display_update(void)
     display.all_flags = 0;
 }
 
+// *************************************************************************************************
+// @fn          display_rate_due
+// @brief       Merge new line data with updates held back before and decide if the line is
+//              redrawn now. A held back update is drawn on a later wakeup.
+// @param       unsigned char line         LINE1, LINE2
+//              unsigned char new_data     1 = Menu item has new display data
+//              unsigned long now          Timer0 timestamp
+// @return      1 = Redraw line now
+// *************************************************************************************************
+unsigned char display_rate_due(unsigned char line, unsigned char new_data, unsigned long now)
+{
+    unsigned char mask = (line == LINE1) ? BIT0 : BIT1;
+    unsigned short min_ticks = (line == LINE1) ? DISPLAY_LINE1_MIN_TICKS : DISPLAY_LINE2_MIN_TICKS;
+
+    if (new_data)
+        sDisplayRate.pending |= mask;
+
+    if (!(sDisplayRate.pending & mask) || (now - sDisplayRate.last[line - 1] < min_ticks))
+        return (0);
+
+    sDisplayRate.pending &= ~mask;
+    sDisplayRate.last[line - 1] = now;
+    return (1);
+}
+
+// *************************************************************************************************
+// @fn          tick_needed
+// @brief       Check if a module needs the 1/1sec tick: measurement timeout, diagnostics refresh,
+//              message cycle, long button press or a line redraw held back by the rate limit.
+// @param       none
+// @return      unsigned char              1 = Tick needed
+// *************************************************************************************************
+unsigned char tick_needed(void)
+{
+#ifdef USE_WATCHDOG
+    // Watchdog is serviced after each wakeup
+    return (1);
+#else
+    return (is_acceleration_measurement() || (ptrMenu_L2 == &menu_L2_Diagnostics) || message.all_flags ||
+            BUTTON_STAR_IS_PRESSED || BUTTON_NUM_IS_PRESSED || sDisplayRate.pending);
+#endif
+}
+
 // *************************************************************************************************
 // @fn          to_lpm
 // @brief       Go to LPM0/3.
@@ -0,0 +1,156 @@
+// *************************************************************************************************
+//      Copyright (C) 2009 Texas Instruments Incorporated - http://www.ti.com/
+//
+//        Redistribution and use in source and binary forms, with or without
+//        modification, are permitted provided that the following conditions
+//        are met:
+//
+//          Redistributions of source code must retain the above copyright
+//          notice, this list of conditions and the following disclaimer.
+//
+//          Redistributions in binary form must reproduce the above copyright
+//          notice, this list of conditions and the following disclaimer in the
+//          documentation and/or other materials provided with the
+//          distribution.
+//
+//          Neither the name of Texas Instruments Incorporated nor the names of
+//          its contributors may be used to endorse or promote products derived
+//          from this software without specific prior written permission.
+//
+//        THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+//        "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+//        LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+//        A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+//        OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+//        SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+//        LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+//        DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+//        THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//        (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+//        OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// *************************************************************************************************
+// *************************************************************************************************
+// Host benchmark of the DTW matcher. Counts repetitions in the traces with the threshold windows
+// alone and with DTW verification, and reports the size and host run time of a match.
+//
+// Build, run and compare with dtw_bench.golden:
+//   make -C tools check
+//
+// Include host run time of dtw_match (not in golden output):
+//   make -C tools bench
+// *************************************************************************************************
+// Include section
+
+// system
+#include "project.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+// logic
+#include "dtw.h"
+#include "exercise.h"
+
+// tools
+#include "trace.h"
+
+// *************************************************************************************************
+// Defines section
+
+// dtw_match calls timed by dtw_bench_time
+#define DTW_BENCH_RUNS                  (100000ul)
+
+// *************************************************************************************************
+// Prototypes section
+unsigned short dtw_bench_cells(void);
+void dtw_bench_time(void);
+
+// *************************************************************************************************
+// @fn          dtw_bench_cells
+// @brief       Cost matrix cells inside the Sakoe-Chiba band, same bounds as dtw_distance.
+// @param       none
+// @return      unsigned short             Cells evaluated per template without abandoning
+// *************************************************************************************************
+unsigned short dtw_bench_cells(void)
+{
+    unsigned short cells = 0;
+    unsigned char i, j_min, j_max;
+
+    for (i = 0; i < DTW_LENGTH; i++)
+    {
+        j_min = (i > DTW_BAND) ? i - DTW_BAND : 0;
+        j_max = (i + DTW_BAND < DTW_LENGTH - 1) ? i + DTW_BAND : DTW_LENGTH - 1;
+        cells += j_max - j_min + 1;
+    }
+
+    return (cells);
+}
+
+// *************************************************************************************************
+// @fn          dtw_bench_time
+// @brief       Host time of a full match against all templates (no template accepted).
+// @param       none
+// @return      none
+// *************************************************************************************************
+void dtw_bench_time(void)
+{
+    unsigned long run;
+    unsigned char i;
+    clock_t start;
+    double usec;
+
+    // Square wave, unlike any template
+    reset_dtw();
+    for (i = 0; i < DTW_LENGTH * DTW_DECIMATION; i++)
+        dtw_add_sample(((i / DTW_DECIMATION) & 1) ? 60 : 0);
+
+    start = clock();
+    for (run = 0; run < DTW_BENCH_RUNS; run++)
+        dtw_match(dtw_templates_rise, DTW_TEMPLATES_RISE, DTW_INFINITY - 1);
+    usec = (double) (clock() - start) * 1e6 / CLOCKS_PER_SEC / DTW_BENCH_RUNS;
+
+    printf("host time of dtw_match: %.2f us for %u templates\n", usec, DTW_TEMPLATES_RISE);
+}
+
+// *************************************************************************************************
+// @fn          main
+// @brief       Compare threshold windows with DTW verification on all traces given.
+// @param       int argc
+//              char ** argv               [-t] trace files
+// @return      int                        0 = ok, 1 = trace not readable
+// *************************************************************************************************
+int main(int argc, char **argv)
+{
+    struct trace trace;
+    unsigned short window, dtw;
+    unsigned char timing = 0;
+    int arg;
+
+    printf("%-28s %6s %6s %6s\n", "trace", "expect", "window", "dtw");
+    for (arg = 1; arg < argc; arg++)
+    {
+        if (strcmp(argv[arg], "-t") == 0)
+        {
+            timing = 1;
+            continue;
+        }
+
+        if (!trace_open(&trace, argv[arg]))
+            return (1);
+        trace_close(&trace);
+
+        window = trace_count_reps(argv[arg], &exercise_situp, TRACE_MEDIAN);
+        dtw = trace_count_reps(argv[arg], &exercise_situp, TRACE_MEDIAN | TRACE_DTW);
+        printf("%-28s %6u %6u %6u\n", argv[arg], trace.expect, window, dtw);
+    }
+
+    printf("dtw cells per template: %u (%u points, band %u)\n", dtw_bench_cells(), DTW_LENGTH,
+           DTW_BAND);
+    printf("dtw RAM: cost rows %u bytes, window %u bytes\n",
+           (unsigned short) (2 * DTW_LENGTH * sizeof(unsigned short)),
+           (unsigned short) (DTW_LENGTH * sizeof(signed short)));
+    if (timing)
+        dtw_bench_time();
+
+    return (0);
+}
@@ -0,0 +1,243 @@
+// *************************************************************************************************
+//      Copyright (C) 2009 Texas Instruments Incorporated - http://www.ti.com/
+//
+//        Redistribution and use in source and binary forms, with or without
+//        modification, are permitted provided that the following conditions
+//        are met:
+//
+//          Redistributions of source code must retain the above copyright
+//          notice, this list of conditions and the following disclaimer.
+//
+//          Redistributions in binary form must reproduce the above copyright
+//          notice, this list of conditions and the following disclaimer in the
+//          documentation and/or other materials provided with the
+//          distribution.
+//
+//          Neither the name of Texas Instruments Incorporated nor the names of
+//          its contributors may be used to endorse or promote products derived
+//          from this software without specific prior written permission.
+//
+//        THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+//        "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+//        LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+//        A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+//        OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+//        SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+//        LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+//        DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+//        THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//        (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+//        OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// *************************************************************************************************
+// *************************************************************************************************
+// Host test of the adaptive exercise detector. Moves through repetitions, holds the signal
+// constant and adds small jitter, then checks that the min/max envelope collapses so the
+// min_span gate keeps noise out of the down phase. Also checks the rise limits of all profiles
+// against the 16-bit int arithmetic of the MSP430.
+//
+// Build and run:
+//   make -C tools check
+// *************************************************************************************************
+// Include section
+
+// system
+#include "project.h"
+#include <stdio.h>
+
+// logic
+#include "acceleration.h"
+#include "exercise.h"
+#include "gravity.h"
+
+// *************************************************************************************************
+// Defines section
+
+// Still wrist must close the gate within this time
+#define GATE_TIMEOUT_SAMPLES            (20u * ACCEL_DETECT_RATE_HZ)
+
+// Resting tilt of the X/Y-axis (10 * mgrav)
+#define REST_X                          (100)
+#define REST_Y                          (100)
+
+// *************************************************************************************************
+// Prototypes section
+signed short exercise_gate_span(void);
+unsigned char exercise_gate_feed(signed short signal);
+unsigned short exercise_gate_int16(unsigned short msec);
+unsigned char exercise_gate_limits(void);
+
+// *************************************************************************************************
+// Global Variable section
+
+// Rise limits of each profile as written in exercise.c (msec)
+struct exercise_gate_limit
+{
+    const struct exercise_profile *profile;
+    unsigned short min_msec;
+    unsigned short max_msec;
+};
+
+const struct exercise_gate_limit exercise_gate_limit[] = {
+    { &exercise_situp, 100, 3000 },
+    { &exercise_pushup, 150, 2500 },
+    { &exercise_squat, 200, 4000 },
+};
+
+// *************************************************************************************************
+// @fn          exercise_gate_span
+// @brief       Envelope span as seen by detect_exercise.
+// @param       none
+// @return      signed short               Span between running max and min of signal
+// *************************************************************************************************
+signed short exercise_gate_span(void)
+{
+    return ((signed short) ((sExercise.env_max - sExercise.env_min) >> EXERCISE_ENVELOPE_FRAC));
+}
+
+// *************************************************************************************************
+// @fn          exercise_gate_feed
+// @brief       Run detector on one sample of the sit-up tilt signal (y - x).
+// @param       signed short signal        Tilt signal relative to rest
+// @return      unsigned char              1 = repetition completed with this sample
+// *************************************************************************************************
+unsigned char exercise_gate_feed(signed short signal)
+{
+    return (detect_exercise(REST_X, REST_Y + signal));
+}
+
+// *************************************************************************************************
+// @fn          exercise_gate_int16
+// @brief       msec to detector samples with the product truncated to a 16-bit int, as cl430
+//              computes it without a 32-bit cast.
+// @param       unsigned short msec        Time
+// @return      unsigned short             Samples
+// *************************************************************************************************
+unsigned short exercise_gate_int16(unsigned short msec)
+{
+    return ((unsigned short) (msec * ACCEL_DETECT_RATE_HZ) / 1000);
+}
+
+// *************************************************************************************************
+// @fn          exercise_gate_limits
+// @brief       Compare the rise limits of all profiles with msec converted in 32 bits.
+// @param       none
+// @return      unsigned char              1 = a limit differs
+// *************************************************************************************************
+unsigned char exercise_gate_limits(void)
+{
+    const struct exercise_gate_limit *limit;
+    unsigned short min_samples, max_samples;
+    unsigned char i, failed = 0;
+
+    for (i = 0; i < sizeof(exercise_gate_limit) / sizeof(exercise_gate_limit[0]); i++)
+    {
+        limit = &exercise_gate_limit[i];
+        min_samples = (unsigned short) (((unsigned long) limit->min_msec * ACCEL_DETECT_RATE_HZ)
+                                        / 1000);
+        max_samples = (unsigned short) (((unsigned long) limit->max_msec * ACCEL_DETECT_RATE_HZ)
+                                        / 1000);
+        printf("%c: rise %u .. %u samples at %uHz (16-bit int multiply: %u .. %u)\n",
+               limit->profile->symbol, limit->profile->min_rise_samples,
+               limit->profile->max_rise_samples, ACCEL_DETECT_RATE_HZ,
+               exercise_gate_int16(limit->min_msec), exercise_gate_int16(limit->max_msec));
+        if ((limit->profile->min_rise_samples != min_samples) ||
+            (limit->profile->max_rise_samples != max_samples))
+        {
+            printf("FAIL: %c expects %u .. %u samples\n", limit->profile->symbol, min_samples,
+                   max_samples);
+            failed = 1;
+        }
+    }
+
+    printf("gravity: learn %u samples (%u ms)\n", GRAVITY_LEARN_SAMPLES,
+           (unsigned short) ((GRAVITY_LEARN_SAMPLES * 1000ul) / ACCEL_DETECT_RATE_HZ));
+    if (GRAVITY_LEARN_SAMPLES != (unsigned short) (3ul * ACCEL_DETECT_RATE_HZ))
+    {
+        printf("FAIL: gravity learn time is not 3 s\n");
+        failed = 1;
+    }
+
+    return (failed);
+}
+
+// *************************************************************************************************
+// @fn          main
+// @brief       Check rise limits, then that the noise gate closes on a still wrist and stays
+//              closed on jitter.
+// @param       none
+// @return      int                        0 = passed, 1 = failed
+// *************************************************************************************************
+int main(void)
+{
+    const struct exercise_profile *profile = &exercise_situp;
+    unsigned short reps = 0;
+    unsigned short sample, engaged;
+    signed short signal, span;
+    unsigned char rep, failed;
+
+    failed = exercise_gate_limits();
+
+    select_exercise(profile);
+
+    // 5 repetitions: 1s down ramp to 60, 0.5s hold, 1s rise back to rest
+    for (rep = 0; rep < 5; rep++)
+    {
+        for (sample = 0; sample < (5u * ACCEL_DETECT_RATE_HZ) / 2; sample++)
+        {
+            if (sample < ACCEL_DETECT_RATE_HZ)
+                signal = (60 * sample) / ACCEL_DETECT_RATE_HZ;
+            else if (sample < (3u * ACCEL_DETECT_RATE_HZ) / 2)
+                signal = 60;
+            else
+                signal = (60 * ((5u * ACCEL_DETECT_RATE_HZ) / 2 - sample)) / ACCEL_DETECT_RATE_HZ;
+            reps += exercise_gate_feed(signal);
+        }
+    }
+    span = exercise_gate_span();
+    printf("movement: %u repetitions, span %d\n", reps, span);
+    if (span < profile->min_span)
+    {
+        printf("FAIL: gate closed during movement\n");
+        failed = 1;
+    }
+
+    // Constant signal: envelope must decay below min_span
+    engaged = 0;
+    for (sample = 1; sample <= GATE_TIMEOUT_SAMPLES; sample++)
+    {
+        exercise_gate_feed(0);
+        if ((engaged == 0) && (exercise_gate_span() < profile->min_span))
+            engaged = sample;
+    }
+    span = exercise_gate_span();
+    if (engaged == 0)
+    {
+        printf("FAIL: gate still open after %u samples, span %d\n", GATE_TIMEOUT_SAMPLES, span);
+        failed = 1;
+    }
+    else
+    {
+        printf("still: gate engaged after %u samples (%u ms), span %d\n", engaged,
+               (unsigned short) ((engaged * 1000ul) / ACCEL_DETECT_RATE_HZ), span);
+    }
+
+    // Jitter below min_span must neither start a down phase nor count repetitions
+    reps = 0;
+    for (sample = 0; sample < 10u * ACCEL_DETECT_RATE_HZ; sample++)
+    {
+        signal = ((sample % 7) * 12) / 6 - 6;
+        reps += exercise_gate_feed(signal);
+        if (sExercise.phase != EXERCISE_PHASE_IDLE)
+        {
+            printf("FAIL: down phase on jitter at sample %u\n", sample);
+            failed = 1;
+            break;
+        }
+    }
+    printf("jitter: %u repetitions, span %d\n", reps, exercise_gate_span());
+    if (reps != 0)
+        failed = 1;
+
+    printf("%s\n", failed ? "exercise gate: FAIL" : "exercise gate: ok");
+    return (failed);
+}
@@ -0,0 +1,333 @@
+// *************************************************************************************************
+//      Copyright (C) 2009 Texas Instruments Incorporated - http://www.ti.com/
+//
+//        Redistribution and use in source and binary forms, with or without
+//        modification, are permitted provided that the following conditions
+//        are met:
+//
+//          Redistributions of source code must retain the above copyright
+//          notice, this list of conditions and the following disclaimer.
+//
+//          Redistributions in binary form must reproduce the above copyright
+//          notice, this list of conditions and the following disclaimer in the
+//          documentation and/or other materials provided with the
+//          distribution.
+//
+//          Neither the name of Texas Instruments Incorporated nor the names of
+//          its contributors may be used to endorse or promote products derived
+//          from this software without specific prior written permission.
+//
+//        THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+//        "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+//        LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+//        A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+//        OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+//        SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+//        LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+//        DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+//        THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//        (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+//        OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// *************************************************************************************************
+// *************************************************************************************************
+// Host checks of the sample filters. Compares the median sorting network with a sort and counts
+// repetitions in spike traces with and without the median filter. With -k the Kalman filter is
+// compared with the 0.2/0.8 EMA on a tilt ramp, gaussian noise and the traces. The Kalman filter
+// fails the check if it passes more noise than the EMA or lags FILTER_BENCH_RAMP_MAX_LAG samples.
+//
+// Build for 3 and 5 median taps and for each detector rate, run and compare with
+// filter_bench.golden:
+//   make -C tools check
+// *************************************************************************************************
+// Include section
+
+// system
+#include "project.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// logic
+#include "acceleration.h"
+#include "exercise.h"
+#include "filter.h"
+
+// tools
+#include "trace.h"
+
+// *************************************************************************************************
+// Defines section
+
+// Random windows compared with a sort
+#define FILTER_BENCH_WINDOWS            (200000ul)
+
+// Tilt ramp from 0 to FILTER_BENCH_RAMP_HEIGHT in 0.5s (10 * mgrav, detector samples)
+#define FILTER_BENCH_RAMP_HEIGHT        (100)
+#define FILTER_BENCH_RAMP_SAMPLES       (ACCEL_DETECT_RATE_HZ / 2)
+
+// Kalman filter must cross mid-level of the ramp in fewer samples after the raw signal
+#define FILTER_BENCH_RAMP_MAX_LAG       (5)
+
+// Gaussian noise around a constant level (10 * mgrav), first samples let the filters settle
+#define FILTER_BENCH_NOISE_LEVEL        (50)
+#define FILTER_BENCH_NOISE_STD          (5.0)
+#define FILTER_BENCH_NOISE_SAMPLES      (20000u)
+#define FILTER_BENCH_NOISE_SETTLE       (200u)
+
+// *************************************************************************************************
+// Prototypes section
+signed short filter_bench_random(void);
+int filter_bench_compare(const void *a, const void *b);
+unsigned long filter_bench_median(void);
+double filter_bench_gauss(void);
+signed short filter_bench_ramp(void);
+unsigned char filter_bench_noise(void);
+
+// *************************************************************************************************
+// Global Variable section
+
+// Random generator state, fixed seed for reproducible output
+unsigned long filter_bench_seed = 1;
+
+// *************************************************************************************************
+// @fn          filter_bench_random
+// @brief       Uniform random sample of -10 .. 10, many equal values in a window.
+// @param       none
+// @return      signed short               Sample
+// *************************************************************************************************
+signed short filter_bench_random(void)
+{
+    filter_bench_seed = filter_bench_seed * 1103515245ul + 12345ul;
+    return ((signed short) ((filter_bench_seed >> 16) % 21) - 10);
+}
+
+// *************************************************************************************************
+// @fn          filter_bench_compare
+// @brief       qsort order of samples.
+// @param       const void * a, b          Samples
+// @return      int                        <0, 0, >0
+// *************************************************************************************************
+int filter_bench_compare(const void *a, const void *b)
+{
+    return (*(const signed short *) a - *(const signed short *) b);
+}
+
+// *************************************************************************************************
+// @fn          filter_bench_median
+// @brief       Run random samples through median_filter and compare with the middle of the
+//              sorted window.
+// @param       none
+// @return      unsigned long              Windows where the network differs from the sort
+// *************************************************************************************************
+unsigned long filter_bench_median(void)
+{
+    struct median filter;
+    signed short window[FILTER_MEDIAN_TAPS], sorted[FILTER_MEDIAN_TAPS], sample, median;
+    unsigned long run, differ = 0;
+    unsigned char i;
+
+    reset_median(&filter);
+    for (run = 0; run < FILTER_BENCH_WINDOWS; run++)
+    {
+        sample = filter_bench_random();
+        median = median_filter(&filter, sample);
+
+        // Reference window, first sample fills all taps like the filter
+        for (i = FILTER_MEDIAN_TAPS - 1; i > 0; i--)
+            window[i] = (run == 0) ? sample : window[i - 1];
+        window[0] = sample;
+
+        for (i = 0; i < FILTER_MEDIAN_TAPS; i++)
+            sorted[i] = window[i];
+        qsort(sorted, FILTER_MEDIAN_TAPS, sizeof(signed short), filter_bench_compare);
+        if (sorted[FILTER_MEDIAN_TAPS / 2] != median)
+            differ++;
+    }
+
+    return (differ);
+}
+
+// *************************************************************************************************
+// @fn          filter_bench_gauss
+// @brief       Standard normal random number (Box-Muller) from the fixed seed generator.
+// @param       none
+// @return      double                     Random number
+// *************************************************************************************************
+double filter_bench_gauss(void)
+{
+    double u1, u2;
+
+    filter_bench_seed = filter_bench_seed * 1103515245ul + 12345ul;
+    u1 = (double) (((filter_bench_seed >> 16) & 0xFFFF) + 1) / 65537.0;
+    filter_bench_seed = filter_bench_seed * 1103515245ul + 12345ul;
+    u2 = (double) ((filter_bench_seed >> 16) & 0xFFFF) / 65536.0;
+
+    return (sqrt(-2.0 * log(u1)) * cos(2.0 * M_PI * u2));
+}
+
+// *************************************************************************************************
+// @fn          filter_bench_ramp
+// @brief       Samples between the raw tilt ramp and the filter outputs crossing mid-level.
+// @param       none
+// @return      signed short               Lag of the Kalman filter, -1 = never crossed
+// *************************************************************************************************
+signed short filter_bench_ramp(void)
+{
+    struct kalman kalman;
+    unsigned short ema = 0;
+    signed short sample, smooth;
+    signed short raw_at = -1, kalman_at = -1, ema_at = -1;
+    unsigned short n;
+
+    reset_kalman(&kalman);
+
+    // 1s rest, ramp, 1s hold
+    for (n = 0; n < 2 * ACCEL_DETECT_RATE_HZ + FILTER_BENCH_RAMP_SAMPLES; n++)
+    {
+        if (n < ACCEL_DETECT_RATE_HZ)
+            sample = 0;
+        else if (n < ACCEL_DETECT_RATE_HZ + FILTER_BENCH_RAMP_SAMPLES)
+            sample = (FILTER_BENCH_RAMP_HEIGHT * (n - ACCEL_DETECT_RATE_HZ + 1)) /
+                     FILTER_BENCH_RAMP_SAMPLES;
+        else
+            sample = FILTER_BENCH_RAMP_HEIGHT;
+
+        smooth = kalman_filter(&kalman, sample);
+        ema = trace_ema(ema, sample);
+
+        if ((raw_at < 0) && (sample >= FILTER_BENCH_RAMP_HEIGHT / 2))
+            raw_at = (signed short) n;
+        if ((kalman_at < 0) && (smooth >= FILTER_BENCH_RAMP_HEIGHT / 2))
+            kalman_at = (signed short) n;
+        if ((ema_at < 0) && (ema >= FILTER_BENCH_RAMP_HEIGHT / 2))
+            ema_at = (signed short) n;
+    }
+
+    printf("ramp to %d in %u samples: mid-level crossed %d samples after raw (kalman), %d (ema)\n",
+           FILTER_BENCH_RAMP_HEIGHT, FILTER_BENCH_RAMP_SAMPLES, kalman_at - raw_at,
+           ema_at - raw_at);
+
+    if (kalman_at < 0)
+        return (-1);
+    return (kalman_at - raw_at);
+}
+
+// *************************************************************************************************
+// @fn          filter_bench_noise
+// @brief       Standard deviation of the filter outputs for gaussian noise on a constant level.
+// @param       none
+// @return      unsigned char              1 = Kalman filter passes more noise than the EMA
+// *************************************************************************************************
+unsigned char filter_bench_noise(void)
+{
+    struct kalman kalman;
+    unsigned short ema = FILTER_BENCH_NOISE_LEVEL;
+    signed short sample, smooth;
+    double sum[3] = { 0, 0, 0 }, square[3] = { 0, 0, 0 }, value[3], count;
+    unsigned short n;
+    unsigned char i;
+
+    reset_kalman(&kalman);
+
+    for (n = 0; n < FILTER_BENCH_NOISE_SAMPLES; n++)
+    {
+        sample = (signed short) lround(FILTER_BENCH_NOISE_LEVEL +
+                                       FILTER_BENCH_NOISE_STD * filter_bench_gauss());
+        if (sample < 0)
+            sample = 0;
+        smooth = kalman_filter(&kalman, sample);
+        ema = trace_ema(ema, sample);
+
+        if (n < FILTER_BENCH_NOISE_SETTLE)
+            continue;
+
+        value[0] = sample;
+        value[1] = smooth;
+        value[2] = ema;
+        for (i = 0; i < 3; i++)
+        {
+            sum[i] += value[i];
+            square[i] += value[i] * value[i];
+        }
+    }
+
+    count = FILTER_BENCH_NOISE_SAMPLES - FILTER_BENCH_NOISE_SETTLE;
+    for (i = 0; i < 3; i++)
+        value[i] = sqrt(square[i] / count - (sum[i] / count) * (sum[i] / count));
+
+    printf("gaussian noise std %.2f: kalman %.2f, ema %.2f, variance ratio %.3f (kalman), "
+           "%.3f (ema)\n", value[0], value[1], value[2],
+           (value[1] * value[1]) / (value[0] * value[0]),
+           (value[2] * value[2]) / (value[0] * value[0]));
+
+    return (value[1] > value[2]);
+}
+
+// *************************************************************************************************
+// @fn          main
+// @brief       Check median network, then count repetitions of all traces given.
+// @param       int argc
+//              char ** argv               [-k] trace files
+// @return      int                        0 = passed, 1 = median mismatch or Kalman check failed
+// *************************************************************************************************
+int main(int argc, char **argv)
+{
+    struct trace trace;
+    unsigned short plain, median, ema;
+    unsigned long differ;
+    unsigned char kalman = 0, failed = 0;
+    signed short lag;
+    int arg = 1;
+
+    differ = filter_bench_median();
+    printf("median %u taps: %lu random windows, %lu differ from sort\n", FILTER_MEDIAN_TAPS,
+           FILTER_BENCH_WINDOWS, differ);
+
+    if ((argc > 1) && (strcmp(argv[1], "-k") == 0))
+    {
+        kalman = 1;
+        arg++;
+
+        printf("kalman gains at %uHz: pos %u/%u, rate %u/%u\n", ACCEL_DETECT_RATE_HZ,
+               FILTER_KALMAN_GAIN_POS, 1u << FILTER_KALMAN_SHIFT, FILTER_KALMAN_GAIN_RATE,
+               1u << FILTER_KALMAN_SHIFT);
+        lag = filter_bench_ramp();
+        if ((lag < 0) || (lag >= FILTER_BENCH_RAMP_MAX_LAG))
+        {
+            printf("FAIL: kalman lags the ramp by %d samples\n", lag);
+            failed = 1;
+        }
+        if (filter_bench_noise())
+        {
+            printf("FAIL: kalman passes more noise than the ema\n");
+            failed = 1;
+        }
+    }
+
+    if (kalman)
+        printf("%-28s %6s %6s %6s\n", "trace", "expect", "ema", "kalman");
+    else
+        printf("%-28s %6s %6s %6s\n", "trace", "expect", "plain", "median");
+    for (; arg < argc; arg++)
+    {
+        if (!trace_open(&trace, argv[arg]))
+            return (1);
+        trace_close(&trace);
+
+        median = trace_count_reps(argv[arg], &exercise_situp, TRACE_MEDIAN | TRACE_DTW);
+        if (kalman)
+        {
+            ema = trace_count_reps(argv[arg], &exercise_situp,
+                                   TRACE_MEDIAN | TRACE_DTW | TRACE_EMA);
+            printf("%-28s %6u %6u %6u\n", argv[arg], trace.expect, ema, median);
+        }
+        else
+        {
+            plain = trace_count_reps(argv[arg], &exercise_situp, TRACE_DTW);
+            printf("%-28s %6u %6u %6u\n", argv[arg], trace.expect, plain, median);
+        }
+    }
+
+    return ((differ != 0) || failed);
+}
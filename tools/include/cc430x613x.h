@@ -0,0 +1,112 @@
+// *************************************************************************************************
+//      Copyright (C) 2009 Texas Instruments Incorporated - http://www.ti.com/
+//
+//        Redistribution and use in source and binary forms, with or without
+//        modification, are permitted provided that the following conditions
+//        are met:
+//
+//          Redistributions of source code must retain the above copyright
+//          notice, this list of conditions and the following disclaimer.
+//
+//          Redistributions in binary form must reproduce the above copyright
+//          notice, this list of conditions and the following disclaimer in the
+//          documentation and/or other materials provided with the
+//          distribution.
+//
+//          Neither the name of Texas Instruments Incorporated nor the names of
+//          its contributors may be used to endorse or promote products derived
+//          from this software without specific prior written permission.
+//
+//        THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+//        "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+//        LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+//        A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+//        OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+//        SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+//        LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+//        DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+//        THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//        (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+//        OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// *************************************************************************************************
+
+#ifndef TOOLS_CC430X613X_H_
+#define TOOLS_CC430X613X_H_
+
+// *************************************************************************************************
+// Host replacement of the CC430F613x device header for the tools in this directory. Provides the
+// LCD_B registers as variables and LCD memory as an array, so driver/display.c and the logic
+// modules build on Linux. Register variables are defined by the tool that uses them.
+// *************************************************************************************************
+
+// *************************************************************************************************
+// Defines section
+#define BIT0                    (0x0001)
+#define BIT1                    (0x0002)
+#define BIT2                    (0x0004)
+#define BIT3                    (0x0008)
+#define BIT4                    (0x0010)
+#define BIT5                    (0x0020)
+#define BIT6                    (0x0040)
+#define BIT7                    (0x0080)
+
+// LCDBCTL0
+#define LCDON                   (0x0001)
+#define LCDSON                  (0x0004)
+#define LCDMX0                  (0x0008)
+#define LCDMX1                  (0x0010)
+#define LCD4MUX                 (LCDMX1 + LCDMX0)
+#define LCDPRE0                 (0x0100)
+#define LCDPRE1                 (0x0200)
+#define LCDPRE2                 (0x0400)
+#define LCDDIV0                 (0x0800)
+#define LCDDIV1                 (0x1000)
+#define LCDDIV2                 (0x2000)
+#define LCDDIV3                 (0x4000)
+#define LCDDIV4                 (0x8000)
+
+// LCDBBLKCTL
+#define LCDBLKMOD0              (0x0001)
+#define LCDBLKMOD1              (0x0002)
+#define LCDBLKPRE0              (0x0004)
+#define LCDBLKPRE1              (0x0008)
+#define LCDBLKPRE2              (0x0010)
+#define LCDBLKDIV0              (0x0020)
+#define LCDBLKDIV1              (0x0040)
+#define LCDBLKDIV2              (0x0080)
+
+// LCDBMEMCTL
+#define LCDDISP                 (0x0001)
+#define LCDCLRM                 (0x0002)
+#define LCDCLRBM                (0x0004)
+
+// LCDBVCTL
+#define LCDCPEN                 (0x0008)
+#define VLCD_2_72               (0x0600)
+
+// LCD memory (LCD_MEM_1 .. LCD_MEM_12, blink memory at +0x20) and counted byte writes
+#define LCD_EMU_MEM_SIZE        (0x40)
+#define LCD_MEM_BASE            (lcd_emu_mem)
+#define LCD_MEM_WRITE(lcdmem, value)    (lcd_emu_writes++, *(lcdmem) = (value))
+
+// Compiler intrinsics, no interrupts on host
+#define __get_interrupt_state()         (0u)
+#define __set_interrupt_state(state)    ((void) (state))
+#define __disable_interrupt()           ((void) 0)
+#define __enable_interrupt()            ((void) 0)
+
+// *************************************************************************************************
+// Global Variable section
+extern unsigned char lcd_emu_mem[LCD_EMU_MEM_SIZE];
+extern unsigned long lcd_emu_writes;
+
+extern volatile unsigned short LCDBCTL0;
+extern volatile unsigned short LCDBBLKCTL;
+extern volatile unsigned short LCDBMEMCTL;
+extern volatile unsigned short LCDBPCTL0;
+extern volatile unsigned short LCDBPCTL1;
+extern volatile unsigned short LCDBVCTL;
+extern volatile unsigned char P5SEL;
+extern volatile unsigned char P5DIR;
+
+#endif /*TOOLS_CC430X613X_H_ */
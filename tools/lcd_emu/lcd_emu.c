@@ -0,0 +1,290 @@
+// *************************************************************************************************
+//      Copyright (C) 2009 Texas Instruments Incorporated - http://www.ti.com/
+//
+//        Redistribution and use in source and binary forms, with or without
+//        modification, are permitted provided that the following conditions
+//        are met:
+//
+//          Redistributions of source code must retain the above copyright
+//          notice, this list of conditions and the following disclaimer.
+//
+//          Redistributions in binary form must reproduce the above copyright
+//          notice, this list of conditions and the following disclaimer in the
+//          documentation and/or other materials provided with the
+//          distribution.
+//
+//          Neither the name of Texas Instruments Incorporated nor the names of
+//          its contributors may be used to endorse or promote products derived
+//          from this software without specific prior written permission.
+//
+//        THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+//        "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+//        LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+//        A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+//        OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+//        SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+//        LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+//        DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+//        THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//        (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+//        OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// *************************************************************************************************
+// Host emulator of LCD_B for driver/display.c. Renders the watch face as 7-segment text and
+// counts LCD memory writes per frame.
+//
+// Build and compare with lcd_emu.golden:
+//   make -C tools check
+//
+// Regenerate lcd_emu.golden after an intended change of driver output:
+//   make -C tools golden
+//
+// Output only depends on the driver, so it can be compared between versions of display.c.
+// *************************************************************************************************
+// Include section
+
+// system
+#include "project.h"
+#include <stdio.h>
+#include <string.h>
+
+// driver
+#include "display.h"
+
+// *************************************************************************************************
+// Prototypes section
+void lcd_emu_reset(void);
+void lcd_emu_frame(const char * title);
+void lcd_emu_render(const unsigned char * mem);
+unsigned char lcd_emu_segments(const unsigned char * mem, unsigned char segment);
+unsigned char lcd_emu_symbol(const unsigned char * mem, unsigned char symbol);
+
+// *************************************************************************************************
+// Global Variable section
+
+// LCD memory and LCD_B registers
+unsigned char lcd_emu_mem[LCD_EMU_MEM_SIZE];
+unsigned long lcd_emu_writes;
+
+volatile unsigned short LCDBCTL0;
+volatile unsigned short LCDBBLKCTL;
+volatile unsigned short LCDBMEMCTL;
+volatile unsigned short LCDBPCTL0;
+volatile unsigned short LCDBPCTL1;
+volatile unsigned short LCDBVCTL;
+volatile unsigned char P5SEL;
+volatile unsigned char P5DIR;
+
+// Frames rendered so far
+unsigned short lcd_emu_frames;
+
+// Display functions reference these, only the driver is linked
+void (*fptr_lcd_function_line1)(unsigned char line, unsigned char update);
+void (*fptr_lcd_function_line2)(unsigned char line, unsigned char update);
+
+// *************************************************************************************************
+// @fn          lcd_emu_reset
+// @brief       Apply LCDBMEMCTL clear requests like LCD_B does.
+// @param       none
+// @return      none
+// *************************************************************************************************
+void lcd_emu_reset(void)
+{
+    if (LCDBMEMCTL & LCDCLRM)
+        memset(LCD_MEM_1, 0, LCD_MEM_SIZE);
+    if (LCDBMEMCTL & LCDCLRBM)
+        memset(LCD_MEM_1 + LCD_BLINK_MEM_OFFSET, 0, LCD_MEM_SIZE);
+    LCDBMEMCTL &= ~(LCDCLRM | LCDCLRBM);
+}
+
+// *************************************************************************************************
+// @fn          lcd_emu_segments
+// @brief       Decode 7-segment character from LCD memory.
+// @param       const unsigned char * mem          Display or blink memory
+//              unsigned char segment              LCD_SEG_L1_3 .. LCD_SEG_L2_0
+// @return      unsigned char                      SEG_A .. SEG_G bits
+// *************************************************************************************************
+unsigned char lcd_emu_segments(const unsigned char * mem, unsigned char segment)
+{
+    unsigned char bits;
+
+    bits = mem[segments_lcdmem[segment] - LCD_MEM_1] & segments_bitmask[segment];
+
+    // Line2 characters have high and low nibble swapped
+    if (segment >= LCD_SEG_L2_5)
+        bits = ((bits << 4) & 0xF0) | ((bits >> 4) & 0x0F);
+
+    return (bits);
+}
+
+// *************************************************************************************************
+// @fn          lcd_emu_symbol
+// @brief       Read single segment from LCD memory.
+// @param       const unsigned char * mem          Display or blink memory
+//              unsigned char symbol               LCD_ICON_xxx, LCD_SEG_xxx_COLx, ...
+// @return      unsigned char                      1 = Segment on
+// *************************************************************************************************
+unsigned char lcd_emu_symbol(const unsigned char * mem, unsigned char symbol)
+{
+    return ((mem[segments_lcdmem[symbol] - LCD_MEM_1] & segments_bitmask[symbol]) != 0);
+}
+
+// *************************************************************************************************
+// @fn          lcd_emu_render
+// @brief       Print icons, Line1 and Line2 as 3 rows of 7-segment text.
+// @param       const unsigned char * mem          Display or blink memory
+// @return      none
+// *************************************************************************************************
+void lcd_emu_render(const unsigned char * mem)
+{
+    const unsigned char line1[] = { LCD_SEG_L1_3, LCD_SEG_L1_2, LCD_SEG_L1_1, LCD_SEG_L1_0 };
+    const unsigned char line2[] = { LCD_SEG_L2_5, LCD_SEG_L2_4, LCD_SEG_L2_3, LCD_SEG_L2_2,
+                                    LCD_SEG_L2_1, LCD_SEG_L2_0 };
+    const unsigned char *digits;
+    unsigned char count;
+    unsigned char row, index, bits;
+    char colon;
+
+    printf("  %s %s %s\n",
+           lcd_emu_symbol(mem, LCD_ICON_STOPWATCH) ? "[STOPWATCH]" : "[         ]",
+           lcd_emu_symbol(mem, LCD_ICON_ALARM) ? "[ALARM]" : "[     ]",
+           lcd_emu_symbol(mem, LCD_UNIT_L1_DEGREE) ? "[DEG]" : "[   ]");
+
+    for (digits = line1, count = sizeof(line1); digits != 0;
+         digits = (digits == line1) ? line2 : 0, count = sizeof(line2))
+    {
+        for (row = 0; row < 3; row++)
+        {
+            printf("  ");
+            for (index = 0; index < count; index++)
+            {
+                bits = lcd_emu_segments(mem, digits[index]);
+                if (row == 0)
+                    printf(" %c ", (bits & SEG_A) ? '_' : ' ');
+                else if (row == 1)
+                    printf("%c%c%c", (bits & SEG_F) ? '|' : ' ', (bits & SEG_G) ? '_' : ' ',
+                           (bits & SEG_B) ? '|' : ' ');
+                else
+                    printf("%c%c%c", (bits & SEG_E) ? '|' : ' ', (bits & SEG_D) ? '_' : ' ',
+                           (bits & SEG_C) ? '|' : ' ');
+
+                // Colons and decimal points between characters
+                colon = ' ';
+                if (digits == line1)
+                {
+                    if ((index == 1) && (row > 0) && lcd_emu_symbol(mem, LCD_SEG_L1_COL))
+                        colon = '.';
+                    if ((index == 1) && (row == 2) && lcd_emu_symbol(mem, LCD_SEG_L1_DP1))
+                        colon = ',';
+                    if ((index == 2) && (row == 2) && lcd_emu_symbol(mem, LCD_SEG_L1_DP0))
+                        colon = ',';
+                }
+                else
+                {
+                    if ((index == 1) && (row > 0) && lcd_emu_symbol(mem, LCD_SEG_L2_COL1))
+                        colon = '.';
+                    if ((index == 3) && (row > 0) && lcd_emu_symbol(mem, LCD_SEG_L2_COL0))
+                        colon = '.';
+                    if ((index == 3) && (row == 2) && lcd_emu_symbol(mem, LCD_SEG_L2_DP))
+                        colon = ',';
+                }
+                printf("%c", colon);
+            }
+            printf("\n");
+        }
+    }
+}
+
+// *************************************************************************************************
+// @fn          lcd_emu_frame
+// @brief       Flush driver shadow to emulated LCD memory, print LCD writes and shown content.
+// @param       const char * title                 Frame description
+// @return      none
+// *************************************************************************************************
+void lcd_emu_frame(const char * title)
+{
+    lcd_emu_writes = 0;
+    lcd_flush();
+    lcd_emu_frames++;
+
+    printf("frame %u: %s, %lu LCD memory writes\n", lcd_emu_frames, title, lcd_emu_writes);
+
+    if (!(LCDBCTL0 & LCDON))
+    {
+        printf("  (LCD off)\n\n");
+        return;
+    }
+
+    // Blink mode 11 alternates display (frame A) and blink memory (frame B)
+    if ((LCDBBLKCTL & (LCDBLKMOD0 | LCDBLKMOD1)) == (LCDBLKMOD0 | LCDBLKMOD1))
+    {
+        printf("  frame A\n");
+        lcd_emu_render(LCD_MEM_1);
+        printf("  frame B\n");
+        lcd_emu_render(LCD_MEM_1 + LCD_BLINK_MEM_OFFSET);
+    }
+    else if (LCDBMEMCTL & LCDDISP)
+    {
+        lcd_emu_render(LCD_MEM_1 + LCD_BLINK_MEM_OFFSET);
+    }
+    else
+    {
+        lcd_emu_render(LCD_MEM_1);
+    }
+    printf("\n");
+}
+
+// *************************************************************************************************
+// @fn          main
+// @brief       Draw a countdown session with the display driver and print every frame.
+// @param       none
+// @return      int                                0
+// *************************************************************************************************
+int main(void)
+{
+    struct lcd_counter reps;
+    unsigned char index;
+
+    lcd_init();
+    lcd_emu_reset();
+
+    // Sit-up counter on Line1, countdown on Line2
+    display_char(LCD_SEG_L1_3, 'S', SEG_ON);
+    display_counter_reset(&reps, LCD_SEG_L1_2, 3, 1);
+    display_counter(&reps, 0);
+    display_chars(LCD_SEG_L2_5_0, (unsigned char *) "006000", SEG_ON);
+    display_symbol(LCD_SEG_L2_COL1, SEG_ON);
+    display_symbol(LCD_SEG_L2_COL0, SEG_ON);
+    lcd_emu_frame("full update");
+
+    // Repetitions: only changed digits are written
+    for (index = 1; index <= 10; index += 9)
+    {
+        display_counter(&reps, index);
+        lcd_emu_frame(index < 10 ? "repetition 1" : "repetition 10");
+    }
+
+    // Stopwatch partial update of 1/100 sec digit
+    display_char(LCD_SEG_L2_0, '9', SEG_ON);
+    lcd_emu_frame("1/100 sec");
+
+    // Nothing changed
+    lcd_emu_frame("no change");
+
+    // Flashing stopwatch icon
+    display_symbol(LCD_ICON_STOPWATCH, SEG_ON);
+    display_animation(LCD_ANIMATION_FAST);
+    display_frame(LCD_FRAME_B);
+    display_symbol(LCD_ICON_STOPWATCH, SEG_OFF);
+    display_frame(LCD_FRAME_BOTH);
+    lcd_emu_frame("icon animation");
+
+    display_animation(LCD_ANIMATION_OFF);
+    display_symbol(LCD_ICON_STOPWATCH, SEG_OFF);
+    lcd_emu_frame("animation off");
+
+    // Blank between sessions
+    lcd_blank(1);
+    lcd_emu_frame("blank");
+
+    return (0);
+}
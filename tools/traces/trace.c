@@ -0,0 +1,206 @@
+// *************************************************************************************************
+//      Copyright (C) 2009 Texas Instruments Incorporated - http://www.ti.com/
+//
+//        Redistribution and use in source and binary forms, with or without
+//        modification, are permitted provided that the following conditions
+//        are met:
+//
+//          Redistributions of source code must retain the above copyright
+//          notice, this list of conditions and the following disclaimer.
+//
+//          Redistributions in binary form must reproduce the above copyright
+//          notice, this list of conditions and the following disclaimer in the
+//          documentation and/or other materials provided with the
+//          distribution.
+//
+//          Neither the name of Texas Instruments Incorporated nor the names of
+//          its contributors may be used to endorse or promote products derived
+//          from this software without specific prior written permission.
+//
+//        THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+//        "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+//        LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+//        A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+//        OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+//        SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+//        LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+//        DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+//        THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//        (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+//        OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// *************************************************************************************************
+// *************************************************************************************************
+// Trace reader and host copy of the sample pipeline of accel_process_sample.
+// *************************************************************************************************
+// Include section
+
+// system
+#include "project.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// logic
+#include "acceleration.h"
+#include "exercise.h"
+#include "filter.h"
+#include "gravity.h"
+
+// tools
+#include "trace.h"
+
+// *************************************************************************************************
+// @fn          trace_open
+// @brief       Open trace and read its expected repetition count.
+// @param       struct trace * trace       Trace
+//              const char * name          File name
+// @return      unsigned char              1 = opened
+// *************************************************************************************************
+unsigned char trace_open(struct trace *trace, const char *name)
+{
+    char line[128];
+    long pos;
+
+    trace->name = name;
+    trace->expect = 0;
+    trace->file = fopen(name, "r");
+    if (trace->file == 0)
+    {
+        fprintf(stderr, "cannot open %s\n", name);
+        return (0);
+    }
+
+    // Header comments
+    for (pos = ftell(trace->file); fgets(line, sizeof(line), trace->file) != 0;
+         pos = ftell(trace->file))
+    {
+        if (line[0] != '#')
+            break;
+        if (strncmp(line, "# expect ", 9) == 0)
+            trace->expect = (unsigned short) atoi(line + 9);
+    }
+    fseek(trace->file, pos, SEEK_SET);
+
+    return (1);
+}
+
+// *************************************************************************************************
+// @fn          trace_read
+// @brief       Read next X/Y/Z sample.
+// @param       struct trace * trace       Trace
+//              signed short * xyz         Sample (10 * mgrav)
+// @return      unsigned char              1 = sample read, 0 = end of trace
+// *************************************************************************************************
+unsigned char trace_read(struct trace *trace, signed short *xyz)
+{
+    int x, y, z;
+
+    if (fscanf(trace->file, "%d %d %d", &x, &y, &z) != 3)
+        return (0);
+
+    xyz[0] = (signed short) x;
+    xyz[1] = (signed short) y;
+    xyz[2] = (signed short) z;
+    return (1);
+}
+
+// *************************************************************************************************
+// @fn          trace_close
+// @brief       Close trace.
+// @param       struct trace * trace       Trace
+// @return      none
+// *************************************************************************************************
+void trace_close(struct trace *trace)
+{
+    fclose(trace->file);
+}
+
+// *************************************************************************************************
+// @fn          trace_ema
+// @brief       X/Y smoothing of accel_process_sample with FILTER_KALMAN set to 0.
+// @param       unsigned short average     Last average
+//              unsigned short sample      Magnitude (10 * mgrav)
+// @return      unsigned short             New average
+// *************************************************************************************************
+unsigned short trace_ema(unsigned short average, unsigned short sample)
+{
+    return ((unsigned short) ((sample * 0.2) + (average * 0.8)));
+}
+
+// *************************************************************************************************
+// @fn          trace_count_reps
+// @brief       Run trace through the filters and exercise detector like accel_process_sample.
+// @param       const char * name                      Trace file
+//              const struct exercise_profile * profile Profile
+//              unsigned char options                  TRACE_DTW, TRACE_MEDIAN, TRACE_EMA
+// @return      unsigned short                         Repetitions detected
+// *************************************************************************************************
+unsigned short trace_count_reps(const char *name, const struct exercise_profile *profile,
+                                unsigned char options)
+{
+    static struct exercise_profile selected;
+    struct trace trace;
+    struct median median[3];
+    struct boxcar boxcar[3];
+    struct kalman kalman[2];
+    signed short xyz[3], smooth;
+    unsigned short accel_x = 0, accel_y = 0;
+    unsigned short reps = 0;
+    unsigned char axis;
+
+    if (!trace_open(&trace, name))
+        exit(1);
+
+    // Without DTW the threshold windows decide alone
+    selected = *profile;
+    if (!(options & TRACE_DTW))
+        selected.templates = 0;
+    select_exercise(&selected);
+
+    for (axis = 0; axis < 3; axis++)
+    {
+        reset_median(&median[axis]);
+        reset_boxcar(&boxcar[axis]);
+    }
+    reset_kalman(&kalman[0]);
+    reset_kalman(&kalman[1]);
+
+    while (trace_read(&trace, xyz))
+    {
+        for (axis = 0; axis < 3; axis++)
+        {
+            if (options & TRACE_MEDIAN)
+                xyz[axis] = median_filter(&median[axis], xyz[axis]);
+#if (ACCEL_DECIMATION_SHIFT > 0)
+            boxcar_filter(&boxcar[axis], xyz[axis], ACCEL_DECIMATION_SHIFT);
+#endif
+        }
+#if (ACCEL_DECIMATION_SHIFT > 0)
+        if (boxcar[2].count != 0)
+            continue;
+        for (axis = 0; axis < 3; axis++)
+            xyz[axis] = boxcar[axis].out;
+#endif
+
+        if (options & TRACE_EMA)
+        {
+            accel_x = trace_ema(accel_x, abs(xyz[0]));
+            accel_y = trace_ema(accel_y, abs(xyz[1]));
+        }
+        else
+        {
+            smooth = kalman_filter(&kalman[0], abs(xyz[0]));
+            accel_x = (smooth < 0) ? 0 : smooth;
+            smooth = kalman_filter(&kalman[1], abs(xyz[1]));
+            accel_y = (smooth < 0) ? 0 : smooth;
+        }
+
+#if (GRAVITY_PROJECTION == 1)
+        gravity_add_sample(xyz[0], xyz[1], xyz[2]);
+#endif
+        reps += detect_exercise(accel_x, accel_y);
+    }
+
+    trace_close(&trace);
+    return (reps);
+}
@@ -0,0 +1,70 @@
+// *************************************************************************************************
+//      Copyright (C) 2009 Texas Instruments Incorporated - http://www.ti.com/
+//
+//        Redistribution and use in source and binary forms, with or without
+//        modification, are permitted provided that the following conditions
+//        are met:
+//
+//          Redistributions of source code must retain the above copyright
+//          notice, this list of conditions and the following disclaimer.
+//
+//          Redistributions in binary form must reproduce the above copyright
+//          notice, this list of conditions and the following disclaimer in the
+//          documentation and/or other materials provided with the
+//          distribution.
+//
+//          Neither the name of Texas Instruments Incorporated nor the names of
+//          its contributors may be used to endorse or promote products derived
+//          from this software without specific prior written permission.
+//
+//        THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+//        "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+//        LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+//        A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+//        OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+//        SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+//        LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+//        DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+//        THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//        (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+//        OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// *************************************************************************************************
+
+#ifndef TRACE_H_
+#define TRACE_H_
+
+// *************************************************************************************************
+// Include section
+#include <project.h>
+#include <stdio.h>
+#include "exercise.h"
+#include "filter.h"
+
+// *************************************************************************************************
+// Defines section
+
+// Options of trace_count_reps
+#define TRACE_DTW                       (0x01u)    // Verify candidates with the DTW matcher
+#define TRACE_MEDIAN                    (0x02u)    // Median filter ahead of the low-pass filters
+#define TRACE_EMA                       (0x04u)    // 0.2/0.8 EMA instead of the Kalman filter
+
+// *************************************************************************************************
+// Global Variable section
+struct trace
+{
+    FILE *file;
+    const char *name;
+    unsigned short expect;                 // Repetitions in trace, from "# expect" line
+};
+
+// *************************************************************************************************
+// Extern section
+extern unsigned char trace_open(struct trace *trace, const char *name);
+extern unsigned char trace_read(struct trace *trace, signed short *xyz);
+extern void trace_close(struct trace *trace);
+extern unsigned short trace_ema(unsigned short average, unsigned short sample);
+extern unsigned short trace_count_reps(const char *name,
+                                       const struct exercise_profile *profile,
+                                       unsigned char options);
+
+#endif                          /*TRACE_H_ */
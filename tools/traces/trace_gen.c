@@ -0,0 +1,263 @@
+// *************************************************************************************************
+//      Copyright (C) 2009 Texas Instruments Incorporated - http://www.ti.com/
+//
+//        Redistribution and use in source and binary forms, with or without
+//        modification, are permitted provided that the following conditions
+//        are met:
+//
+//          Redistributions of source code must retain the above copyright
+//          notice, this list of conditions and the following disclaimer.
+//
+//          Redistributions in binary form must reproduce the above copyright
+//          notice, this list of conditions and the following disclaimer in the
+//          documentation and/or other materials provided with the
+//          distribution.
+//
+//          Neither the name of Texas Instruments Incorporated nor the names of
+//          its contributors may be used to endorse or promote products derived
+//          from this software without specific prior written permission.
+//
+//        THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+//        "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+//        LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+//        A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+//        OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+//        SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+//        LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+//        DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+//        THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//        (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+//        OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// *************************************************************************************************
+// *************************************************************************************************
+// Generator of synthetic acceleration traces for the host tools. Traces are X/Y/Z in 10 * mgrav
+// at ACCEL_SAMPLE_RATE_HZ, the values accel_process_sample gets after conversion. Recorded
+// traces in the same format can be added next to the generated ones.
+//
+// Regenerate all traces:
+//   make -C tools traces
+// *************************************************************************************************
+// Include section
+
+// system
+#include "project.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// logic
+#include "acceleration.h"
+
+// *************************************************************************************************
+// Defines section
+
+// Trace length and quiet start (sec)
+#define TRACE_SECONDS                   (40u)
+#define TRACE_QUIET_SECONDS             (2.0)
+
+// Torso tilt between lying and sitting (degree)
+#define TRACE_TILT_DEGREE               (70.0)
+
+// Single sample spikes from arm jerks: height (10 * mgrav) and mean distance (samples)
+#define TRACE_SPIKE_HEIGHT              (150)
+#define TRACE_SPIKE_DISTANCE            (100u)
+
+// *************************************************************************************************
+// Prototypes section
+signed short trace_noise(void);
+void trace_sample(double tilt, unsigned char flip, signed short spike);
+double trace_situp_tilt(double t, double period);
+unsigned short trace_situp_reps(double period);
+void trace_situp(double period, unsigned char flip);
+void trace_fidget(double period);
+void trace_spikes(double period);
+
+// *************************************************************************************************
+// Global Variable section
+
+// Noise generator state, fixed seed for reproducible traces
+unsigned long trace_seed = 1;
+
+// *************************************************************************************************
+// @fn          trace_noise
+// @brief       Uniform sensor noise of -3 .. 3, independent of the host C library.
+// @param       none
+// @return      signed short               Noise (10 * mgrav)
+// *************************************************************************************************
+signed short trace_noise(void)
+{
+    trace_seed = trace_seed * 1103515245ul + 12345ul;
+    return ((signed short) ((trace_seed >> 16) % 7) - 3);
+}
+
+// *************************************************************************************************
+// @fn          trace_sample
+// @brief       Print gravity of a wrist on the chest, tilted with the torso, plus noise on X/Y.
+// @param       double tilt                Torso tilt, 0 = lying .. 1 = sitting
+//              unsigned char flip         1 = watch worn upside down
+//              signed short spike         Added to X (10 * mgrav)
+// @return      none
+// *************************************************************************************************
+void trace_sample(double tilt, unsigned char flip, signed short spike)
+{
+    double angle = tilt * TRACE_TILT_DEGREE * M_PI / 180.0;
+    double gx = -100.0 * sin(angle);
+    double gy = 70.0 * cos(angle);
+    double gz = -70.0 * cos(angle);
+
+    if (flip)
+    {
+        gx = -gx;
+        gy = -gy;
+        gz = -gz;
+    }
+    gx += trace_noise() + spike;
+    gy += trace_noise();
+
+    printf("%d %d %d\n", (int) gx, (int) gy, (int) gz);
+}
+
+// *************************************************************************************************
+// @fn          trace_situp_tilt
+// @brief       Sit-ups: lie 40%, rise 24%, sit 12%, lie down again 24% of each period.
+// @param       double t                   Time (sec)
+//              double period              Repetition period (sec)
+// @return      double                     Torso tilt, 0 = lying .. 1 = sitting
+// *************************************************************************************************
+double trace_situp_tilt(double t, double period)
+{
+    double lie = period * 0.4, rise = period * 0.24, sit = period * 0.12;
+    double p = fmod(t, period);
+
+    if ((t < TRACE_QUIET_SECONDS) || (p < lie))
+        return (0.0);
+    if (p < lie + rise)
+        return ((p - lie) / rise);
+    if (p < lie + rise + sit)
+        return (1.0);
+    return (1.0 - (p - lie - rise - sit) / (period - lie - rise - sit));
+}
+
+// *************************************************************************************************
+// @fn          trace_situp_reps
+// @brief       Rises that start after the quiet start and end inside the trace.
+// @param       double period              Repetition period (sec)
+// @return      unsigned short             Repetitions
+// *************************************************************************************************
+unsigned short trace_situp_reps(double period)
+{
+    double t;
+    unsigned short reps = 0;
+
+    for (t = 0; t + period * 0.64 <= TRACE_SECONDS; t += period)
+    {
+        if (t + period * 0.4 >= TRACE_QUIET_SECONDS)
+            reps++;
+    }
+
+    return (reps);
+}
+
+// *************************************************************************************************
+// @fn          trace_situp
+// @brief       Sit-ups with a constant period.
+// @param       double period              Repetition period (sec)
+//              unsigned char flip         1 = watch worn upside down
+// @return      none
+// *************************************************************************************************
+void trace_situp(double period, unsigned char flip)
+{
+    unsigned short n;
+
+    printf("# situp period %.1fs%s\n", period, flip ? ", upside down" : "");
+    printf("# expect %u\n", trace_situp_reps(period));
+
+    for (n = 0; n < TRACE_SECONDS * ACCEL_SAMPLE_RATE_HZ; n++)
+        trace_sample(trace_situp_tilt((double) n / ACCEL_SAMPLE_RATE_HZ, period), flip, 0);
+}
+
+// *************************************************************************************************
+// @fn          trace_fidget
+// @brief       Continuous swinging between half tilt and full tilt, no repetition.
+// @param       double period              Swing period (sec)
+// @return      none
+// *************************************************************************************************
+void trace_fidget(double period)
+{
+    unsigned short n;
+    double t;
+
+    printf("# fidget period %.1fs\n", period);
+    printf("# expect 0\n");
+
+    for (n = 0; n < TRACE_SECONDS * ACCEL_SAMPLE_RATE_HZ; n++)
+    {
+        t = (double) n / ACCEL_SAMPLE_RATE_HZ;
+        trace_sample(0.5 + 0.5 * sin(2.0 * M_PI * t / period), 0, 0);
+    }
+}
+
+// *************************************************************************************************
+// @fn          trace_spikes
+// @brief       Single sample spikes on X, alternating sign, while lying still or doing sit-ups.
+// @param       double period              Sit-up period (sec), 0 = lying still
+// @return      none
+// *************************************************************************************************
+void trace_spikes(double period)
+{
+    unsigned short n, next = TRACE_SPIKE_DISTANCE;
+    signed short spike, height = TRACE_SPIKE_HEIGHT;
+    double tilt;
+
+    if (period > 0)
+        printf("# situp period %.1fs with spikes\n", period);
+    else
+        printf("# lying still with spikes\n");
+    printf("# expect %u\n", (period > 0) ? trace_situp_reps(period) : 0);
+
+    for (n = 0; n < TRACE_SECONDS * ACCEL_SAMPLE_RATE_HZ; n++)
+    {
+        spike = 0;
+        if (n == next)
+        {
+            spike = height;
+            height = -height;
+            next += TRACE_SPIKE_DISTANCE / 2 + (trace_noise() + 3) * (TRACE_SPIKE_DISTANCE / 6);
+        }
+
+        tilt = (period > 0) ? trace_situp_tilt((double) n / ACCEL_SAMPLE_RATE_HZ, period) : 0.0;
+        trace_sample(tilt, 0, spike);
+    }
+}
+
+// *************************************************************************************************
+// @fn          main
+// @brief       Print trace selected by arguments.
+// @param       int argc
+//              char ** argv               situp <period> [flip] | fidget <period> |
+//                                         spikes <period>
+// @return      int                        0 = ok, 1 = unknown trace
+// *************************************************************************************************
+int main(int argc, char **argv)
+{
+    if (argc < 3)
+    {
+        fprintf(stderr, "usage: %s situp <period> [flip] | fidget <period> | spikes <period>\n",
+                argv[0]);
+        return (1);
+    }
+
+    printf("# SIT UP acceleration trace: X Y Z (10 * mgrav) at %uHz\n", ACCEL_SAMPLE_RATE_HZ);
+
+    if (strcmp(argv[1], "situp") == 0)
+        trace_situp(atof(argv[2]), (argc > 3) && (strcmp(argv[3], "flip") == 0));
+    else if (strcmp(argv[1], "fidget") == 0)
+        trace_fidget(atof(argv[2]));
+    else if (strcmp(argv[1], "spikes") == 0)
+        trace_spikes(atof(argv[2]));
+    else
+        return (1);
+
+    return (0);
+}